@@ -1,51 +1,127 @@
 #include <iostream>
-#include <fstream>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <memory>
+#include <vector>
 #include "../lite_string.h"
 
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define CHEAP_GREP_HAS_MMAP 1
+#else
+#define CHEAP_GREP_HAS_MMAP 0
+#endif
+
 /// A lambda function to free a lite_string object.
 auto string_deleter = [](lite_string *ls) -> void { string_free(ls); };
 
+/// A lambda function to free a lite_line_reader object.
+auto reader_deleter = [](lite_line_reader *r) -> void { line_reader_free(r); };
+
 /**
  * @brief A simple emulation of the grep command.
  *
- * This function reads the input stream line by line and prints the lines that contain the specified pattern.
+ * This function reads the input file line by line and prints the lines that contain the specified pattern.
  *
  * @param pattern The pattern to search for.
- * @param input The input stream to read from.
+ * @param input The file to read from.
  * @param ignoreCase Whether to ignore the case of the characters.
  * @return 0 if the pattern is found, 1 otherwise.
  */
-int cheap_grep(const lite_string *pattern, std::istream &input, const bool ignoreCase) {
-    // Unique pointers to manage lite_string objects.
+int cheap_grep(const lite_string *pattern, FILE *input, const bool ignoreCase) {
+    // Unique pointers to manage the lite_string and lite_line_reader objects.
     const std::unique_ptr<lite_string, decltype(string_deleter)> s(string_new(), string_deleter);
-    const std::unique_ptr<lite_string, decltype(string_deleter)> patternCopy(string_new(), string_deleter);
-    const std::unique_ptr<lite_string, decltype(string_deleter)> lineCopy(string_new(), string_deleter);
+    const std::unique_ptr<lite_line_reader, decltype(reader_deleter)> reader(line_reader_new(input), reader_deleter);
+    if (!s || !reader) return 1;
 
-    string_copy(pattern, patternCopy.get());
-    if (ignoreCase) string_to_lower(patternCopy.get());
+    // Case-insensitive search folds the case on the fly, so the lines are searched in place.
+    const auto find = ignoreCase ? string_find_case : string_find;
 
-    char line[4096];
     int ret{1};
 
-    while (input.getline(line, sizeof line)) {
-        string_append_cstr(s.get(), line);
-        string_copy(s.get(), lineCopy.get());
-
-        if (ignoreCase) string_to_lower(lineCopy.get());
-
-        if (string_find(lineCopy.get(), patternCopy.get()) != lite_string_npos) {
+    // The lines are read in large blocks, and each one reuses the memory of the same string.
+    while (string_getline(reader.get(), s.get())) {
+        if (find(s.get(), pattern) != lite_string_npos) {
             ret = 0;
-            std::cout << line << '\n';
+            std::cout.write(string_data(s.get()), static_cast<std::streamsize>(string_size(s.get()))) << '\n';
         }
-
-        string_clear(s.get());
     }
 
     return ret;
 }
 
+#if CHEAP_GREP_HAS_MMAP
+/**
+ * @brief Searches a memory-mapped file with all the processors of the machine.
+ *
+ * The file is searched in large windows that end after a newline, so that the list of matches stays small.
+ * Each window is split between the threads by string_view_parallel_find_all(),
+ * and the lines containing the matches are printed in order.
+ *
+ * @param pattern The pattern to search for. It must not be empty.
+ * @param text The contents of the file.
+ * @return 0 if the pattern is found, 1 if it is not, and 2 on error.
+ */
+int cheap_grep_mapped(const lite_string *pattern, const lite_string_view text) {
+    constexpr size_t windowSize = size_t{256} << 20;
+    const lite_string_view needle{string_data(pattern), string_size(pattern)};
+    std::vector<size_t> positions(4096);
+
+    int ret{1};
+    size_t start = 0;
+    while (start < text.size) {
+        size_t end = text.size - start > windowSize ? start + windowSize : text.size;
+        const auto *newline = static_cast<const char *>(std::memchr(text.data + end - 1, '\n', text.size - end + 1));
+        end = newline ? static_cast<size_t>(newline - text.data) + 1 : text.size;
+
+        const lite_string_view window{text.data + start, end - start};
+
+        // The positions are kept in a fixed buffer, so when a window has more matches than fit, the rest of it
+        // is searched again from the line after the last one printed, in spans as long as the part just printed
+        size_t cursor = 0, span = window.size;
+        while (cursor < window.size) {
+            size_t limit = window.size - cursor > span ? cursor + span : window.size;
+            const auto *feed =
+                static_cast<const char *>(std::memchr(window.data + limit - 1, '\n', window.size - limit + 1));
+            limit = feed ? static_cast<size_t>(feed - window.data) + 1 : window.size;
+
+            const lite_string_view part{window.data + cursor, limit - cursor};
+            const size_t count = string_view_parallel_find_all(part, needle, positions.data(), positions.size(), 0);
+            if (count == lite_string_npos) return 2;
+
+            // Print each matching line once, however many matches it contains
+            const size_t stored = count < positions.size() ? count : positions.size();
+            size_t printedEnd = 0;
+            for (size_t i = 0; i < stored; ++i) {
+                const size_t pos = cursor + positions[i];
+                if (pos < printedEnd) continue;
+                size_t lineStart = pos;
+                while (lineStart > 0 && window.data[lineStart - 1] != '\n') --lineStart;
+                const auto *lineEnd = static_cast<const char *>(std::memchr(window.data + pos, '\n', limit - pos));
+                printedEnd = lineEnd ? static_cast<size_t>(lineEnd - window.data) : limit;
+
+                size_t length = printedEnd - lineStart;
+                if (length && window.data[lineStart + length - 1] == '\r') --length;
+                std::cout.write(window.data + lineStart, static_cast<std::streamsize>(length)) << '\n';
+                ret = 0;
+            }
+            if (count > stored) {
+                span = printedEnd + 1 - cursor;
+                cursor = printedEnd + 1;
+            } else {
+                cursor = limit;
+            }
+        }
+        start = end;
+    }
+    return ret;
+}
+#endif
+
 int main(const int argc, char *argv[]) {
     if (argc < 3) {
         std::cerr << "Usage: " << argv[0] << " [-i] <pattern> <filename>\n";
@@ -69,13 +145,34 @@ int main(const int argc, char *argv[]) {
 
     // If the filename is "-", read from stdin.
     if (string_compare_cstr(filename.get(), "-"))
-        return cheap_grep(pattern.get(), std::cin, ignoreCase);
+        return cheap_grep(pattern.get(), stdin, ignoreCase);
+
+#if CHEAP_GREP_HAS_MMAP
+    // Regular files are mapped and searched in parallel. The case-insensitive search reads the lines instead.
+    if (!ignoreCase && string_size(pattern.get()) > 0) {
+        const int fd = open(string_cstr(filename.get()), O_RDONLY | O_CLOEXEC);
+        struct stat st{};
+        if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            const auto size = static_cast<size_t>(st.st_size);
+            void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                close(fd);
+                const int ret = cheap_grep_mapped(pattern.get(), {static_cast<const char *>(map), size});
+                munmap(map, size);
+                return ret;
+            }
+        }
+        if (fd >= 0) close(fd);
+    }
+#endif
 
     // Open the file and read from it.
-    std::ifstream file(string_cstr(filename.get()));
-    if (!file.is_open()) {
+    FILE *file = std::fopen(string_cstr(filename.get()), "rb");
+    if (!file) {
         std::cerr << "Error: Unable to open file: " << std::quoted(string_cstr(filename.get())) << std::endl;
         return 1;
     }
-    return cheap_grep(pattern.get(), file, ignoreCase);
+    const int ret = cheap_grep(pattern.get(), file, ignoreCase);
+    std::fclose(file);
+    return ret;
 }
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 
 #ifndef __has_include
 #define __has_include(x) 0 // Compatibility with non-GNU compilers
@@ -31,20 +32,6 @@
 #define __has_builtin(x) 0 // For compilers that do not support __has_builtin
 #endif // !__has_builtin
 
-#define HAS_STRNCASECMP 1
-#if _MSC_VER || _WIN32 || _WIN64 || WIN32
-#define strncasecmp _strnicmp // Windows equivalent
-#elif _GNU_SOURCE || _DEFAULT_SOURCE
-// strncasecmp is available as a GNU extension
-#elif __has_include(<strings.h>) || _POSIX_C_SOURCE >= 200112L
-#include <strings.h> // POSIX strncasecmp is available
-#else
-// strncasecmp is not available, use a custom implementation
-#undef HAS_STRNCASECMP
-#define HAS_STRNCASECMP 0
-#include <ctype.h> // For tolower()
-#endif // _MSC_VER || _WIN32 || _WIN64 || WIN32
-
 #if __STDC_VERSION__ >= 202311L // C23 or later, use the new attributes if available
 #if HAS_ATTRIBUTE(always_inline)
 #define LITE_ATTR_ALWAYS_INLINE [[gnu::always_inline]]
@@ -74,17 +61,203 @@
 #endif // HAS_ATTRIBUTE(__unused__)
 #endif // __STDC_VERSION__ >= 202311L
 
+// Vectorized code paths. SSE2 is part of the x86-64 baseline, so no runtime detection is needed.
+// Define LITE_STRING_NO_SIMD to a value greater than 0 to build the portable scalar code only.
+#ifndef LITE_STRING_NO_SIMD
+#define LITE_STRING_NO_SIMD 0
+#endif // LITE_STRING_NO_SIMD
+
+#if !LITE_STRING_NO_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define LITE_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define LITE_HAS_SSE2 0
+#endif // !LITE_STRING_NO_SIMD && (defined(__SSE2__) || ...)
+
+#if _MSC_VER && !defined(__clang__)
+#include <intrin.h> // For _BitScanForward()
+#endif // _MSC_VER && !defined(__clang__)
+
+// Parallel algorithms run on POSIX threads or Windows threads.
+// Define LITE_STRING_NO_THREADS to a value greater than 0 to run them on the calling thread only.
+#ifndef LITE_STRING_NO_THREADS
+#define LITE_STRING_NO_THREADS 0
+#endif // LITE_STRING_NO_THREADS
+
+#if LITE_STRING_NO_THREADS
+#define LITE_HAS_THREADS 0
+#elif _WIN32
+#define LITE_HAS_THREADS 1
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#elif __has_include(<pthread.h>)
+#define LITE_HAS_THREADS 1
+#include <pthread.h>
+#include <unistd.h> // For sysconf()
+#else
+#define LITE_HAS_THREADS 0
+#endif // LITE_STRING_NO_THREADS
+
+// Files are read through their descriptors with the low-level I/O functions of the platform
+#if _WIN32
+#define LITE_HAS_FILES 1
+#include <io.h> // For _open(), _read() and _lseeki64()
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h> // For _fstat64()
+#elif __has_include(<unistd.h>)
+#define LITE_HAS_FILES 1
+#include <unistd.h> // For read(), write() and lseek()
+#include <fcntl.h> // For open()
+#include <sys/stat.h> // For fstat()
+#include <sys/uio.h> // For writev()
+#include <limits.h> // For IOV_MAX
+#else
+#define LITE_HAS_FILES 0
+#endif // _WIN32
+#include <errno.h>
+
+/**
+ * @brief Counts the trailing zero bits of a non-zero integer.
+ *
+ * @param x The input integer, which must not be zero.
+ * @return The number of trailing zero bits.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline unsigned lite_ctz_(const unsigned x) {
+#if __has_builtin(__builtin_ctz) || __GNUC__
+    return (unsigned) __builtin_ctz(x);
+#elif _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (unsigned) index;
+#else
+    unsigned n = 0;
+    while (!(x & (1u << n))) ++n;
+    return n;
+#endif
+}
+
+/**
+ * @brief Counts the trailing zero bits of a non-zero 64-bit integer.
+ *
+ * @param x The input integer, which must not be zero.
+ * @return The number of trailing zero bits.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline unsigned lite_ctz64_(const uint64_t x) {
+#if __has_builtin(__builtin_ctzll) || __GNUC__
+    return (unsigned) __builtin_ctzll(x);
+#else
+    return (uint32_t) x ? lite_ctz_((uint32_t) x) : 32 + lite_ctz_((uint32_t) (x >> 32));
+#endif
+}
+
+/**
+ * @brief Counts the set bits of an integer.
+ *
+ * @param x The input integer.
+ * @return The number of set bits.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline unsigned lite_popcount_(unsigned x) {
+#if __has_builtin(__builtin_popcount) || __GNUC__
+    return (unsigned) __builtin_popcount(x);
+#else
+    unsigned n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+
+/// The largest byte set that is matched with vector comparisons, rather than with a lookup table alone.
+#define LITE_SMALL_SET 8
+
+#if LITE_HAS_SSE2
+/**
+ * @brief Checks which bytes of a vector belong to a small set of bytes.
+ *
+ * @param block The vector to be checked.
+ * @param set The members of the set, each broadcast to a full vector.
+ * @param count The number of members, at most \p LITE_SMALL_SET
+ * @return A bitmask with a bit set for each byte of the vector that belongs to the set.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline unsigned
+lite_small_set_mask_(const __m128i block, const __m128i *const restrict set, const size_t count) {
+    __m128i hits = _mm_setzero_si128();
+    for (size_t i = 0; i < count; ++i)
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, set[i]));
+    return (unsigned) _mm_movemask_epi8(hits);
+}
+
+/**
+ * @brief Finds the whitespace characters in a vector.
+ *
+ * A byte is whitespace if it is a space, or if it lies between '\t' and '\r' inclusive.
+ *
+ * @param block The vector to be checked.
+ * @return A vector with all the bits set in each whitespace byte, and cleared in the others.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline __m128i lite_space_bytes_(const __m128i block) {
+    // (c - '\t') <= 4 as an unsigned comparison, since min(x, 4) == x only if x <= 4
+    const __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+    const __m128i space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+    return _mm_or_si128(control, space);
+}
+
+/**
+ * @brief Checks which bytes of a vector are whitespace characters.
+ *
+ * @param block The vector to be checked.
+ * @return A bitmask with a bit set for each whitespace byte of the vector.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline unsigned lite_space_mask_(const __m128i block) {
+    return (unsigned) _mm_movemask_epi8(lite_space_bytes_(block));
+}
+
+/**
+ * @brief Adds up the unsigned bytes of a vector.
+ *
+ * @param lanes The vector.
+ * @return The sum of its 16 bytes.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline size_t lite_sum_lanes_sse2_(const __m128i lanes) {
+    const __m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+    return (size_t) _mm_cvtsi128_si32(sums) + (size_t) _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+}
+#endif // LITE_HAS_SSE2
+
 /**
  * @brief A simple emulation of a C++ string in C.
  *
  * The data is stored as a pointer to a dynamically allocated array of characters.\n
  * The capacity represents the total number of characters that the string can hold without needing to be resized.\n
- * When the size reaches the capacity, the string is resized to a larger capacity to accommodate more characters.
+ * When the size reaches the capacity, the string is resized to a larger capacity to accommodate more characters.\n
+ * Characters removed from the front of the string are skipped by advancing the data pointer,
+ * and the offset records how far it was advanced from the start of the allocation.
  */
 struct lite_string {
     char *data; ///< A pointer to the character data.
     size_t size; ///< The number of characters in the string, not including the null character.
     size_t capacity; ///< The total number of characters that the string can hold.
+    size_t offset; ///< The number of characters between the start of the allocation and the data pointer.
 };
 
 /**
@@ -99,6 +272,7 @@ LITE_ATTR_NODISCARD LITE_ATTR_HOT lite_string *string_new(void) {
         if ((s->data = (char *) calloc(16, sizeof(char)))) {
             s->size = 0;
             s->capacity = 16;
+            s->offset = 0;
             return s;
         }
         // If memory allocation failed, free the string
@@ -136,11 +310,12 @@ LITE_ATTR_NODISCARD LITE_ATTR_HOT lite_string *string_new_cstr(const char *const
 LITE_ATTR_HOT void string_free(lite_string *const restrict s) {
     if (s) {
         if (s->data) {
-            free(s->data);
+            free(s->data - s->offset);
             s->data = nullptr;
         }
         s->size = 0;
         s->capacity = 0;
+        s->offset = 0;
 
         free(s);
     }
@@ -161,10 +336,50 @@ LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline size_t lite_clp2_(si
     x |= x >> 4;
     x |= x >> 8;
     x |= x >> 16;
+#if SIZE_MAX > UINT32_MAX
+    x |= x >> 32;
+#endif // SIZE_MAX > UINT32_MAX
 
     return ++x;
 }
 
+/**
+ * @brief Moves the characters of a string back to the start of its allocation.
+ *
+ * This reclaims the space skipped by trimming the front of the string.
+ *
+ * @param s A pointer to the string to be moved.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_rebase_(lite_string *const restrict s) {
+    char *const base = s->data - s->offset;
+    memmove(base, s->data, s->size);
+    // The characters beyond the new end are stale, the ones beyond the old end are already zero
+    memset(base + s->size, '\0', s->offset);
+
+    s->data = base;
+    s->capacity += s->offset;
+    s->offset = 0;
+}
+
+/**
+ * @brief Removes characters from the front of a string, without moving the others.
+ *
+ * The start of the string is advanced instead, and the skipped space is reclaimed the next time the string has to grow.
+ *
+ * @param s A pointer to the string.
+ * @param n The number of characters to remove, which must not be greater than the size of the string.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline void lite_drop_front_(lite_string *const restrict s, const size_t n) {
+    s->data += n;
+    s->size -= n;
+    s->capacity -= n;
+    s->offset += n;
+}
+
 /**
  * @brief Resizes the string to the given size.
  *
@@ -182,12 +397,19 @@ LITE_ATTR_HOT bool string_reserve(lite_string *const restrict s, size_t size) {
         // Space for the null terminator
         ++size;
 
-        // Round up the new size to the next power of 2
+        // Round up the new size to the next power of 2, which wraps to 0 if it is too large
         size = lite_clp2_(size);
+        if (size == 0) return false;
         if (size < 16) size = 16;
 
         // Reallocate the memory
         if (size > s->capacity - 1) {
+            // Reclaim the space skipped by trimming first, which may be enough
+            if (s->offset) {
+                lite_rebase_(s);
+                if (size <= s->capacity - 1) return true;
+            }
+
             void *temp = realloc(s->data, size * sizeof(char));
             if (temp == nullptr) return false;
 
@@ -203,6 +425,30 @@ LITE_ATTR_HOT bool string_reserve(lite_string *const restrict s, size_t size) {
     return false;
 }
 
+/**
+ * @brief Inserts a number of bytes into a string at a specified index.
+ *
+ * The length is trusted as it is, so the bytes are not scanned, and they may contain null characters.
+ *
+ * @param s A pointer to the string where the bytes will be inserted.
+ * @param data A pointer to the bytes, which must not point into the string. Can be nullptr if \p len is 0.
+ * @param index The index at which the bytes will be inserted, at most the size of the string.
+ * @param len The number of bytes to be inserted.
+ * @return true if the bytes were successfully inserted, false otherwise.
+ */
+bool string_insert_mem(lite_string *const restrict s, const void *const restrict data, const size_t index,
+                       const size_t len) {
+    if (s == nullptr || (data == nullptr && len) || index > s->size) return false;
+    if (len == 0) return true;
+    if (len > SIZE_MAX - 1 - s->size || !string_reserve(s, s->size + len)) return false;
+
+    // Move the characters after the index to make room for the bytes
+    memmove(s->data + index + len, s->data + index, s->size - index);
+    memcpy(s->data + index, data, len);
+    s->size += len;
+    return true;
+}
+
 /**
  * @brief Inserts a specified number of characters from a C-string into a string at a specified index.
  *
@@ -219,25 +465,8 @@ bool string_insert_cstr_range(lite_string *const restrict s, const char *const r
                               const size_t index, const size_t count) {
     if (s && cstr) {
         if (!count) return true;
-        if (count <= strlen(cstr)) {
-            // The index must be within the bounds of the string
-            if (index < s->size) {
-                // Resize the string if necessary
-                if (s->size + count >= s->capacity - 1) {
-                    if (!string_reserve(s, s->size + count)) return false;
-                }
-                // Move the characters after the index to make room for the C-string
-                memmove(s->data + (index + count) * sizeof(char), s->data + index * sizeof(char),
-                        (s->size - index) * sizeof(char));
-
-                // Copy the C-string into the string
-                memcpy(s->data + index * sizeof(char), cstr, count * sizeof(char));
-                s->size += count;
-
-                return true;
-            }
-            if (index == s->size) return string_append_cstr_range(s, cstr, count);
-        }
+        // The C-string must not end within the range, which is checked without scanning past it
+        if (memchr(cstr, '\0', count) == nullptr) return string_insert_mem(s, cstr, index, count);
     }
     return false;
 }
@@ -251,7 +480,7 @@ bool string_insert_cstr_range(lite_string *const restrict s, const char *const r
  * @return true if the C-string was successfully inserted, false otherwise.
  */
 bool string_insert_cstr(lite_string *const restrict s, const char *restrict cstr, const size_t index) {
-    return cstr && string_insert_cstr_range(s, cstr, index, strlen(cstr));
+    return cstr && string_insert_mem(s, cstr, index, strlen(cstr));
 }
 
 
@@ -299,8 +528,9 @@ LITE_ATTR_REPRODUCIBLE char string_at(const lite_string *const restrict s, const
  * @param s A pointer to the string.
  */
 void string_pop_back(lite_string *const restrict s) {
-    if (s && s->size)
+    if (s && s->size) {
         s->data[--s->size] = '\0';
+    }
 }
 
 /**
@@ -384,6 +614,311 @@ bool string_erase(lite_string *const restrict s, const size_t index) {
     return false;
 }
 
+/**
+ * @brief Multiplies two 64-bit integers into a 128-bit product.
+ *
+ * @param a A pointer to the first factor, which receives the low half of the product.
+ * @param b A pointer to the second factor, which receives the high half of the product.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline void lite_mum_(uint64_t *const restrict a, uint64_t *const restrict b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ const unsigned __int128 r = (unsigned __int128) *a * *b;
+    *a = (uint64_t) r;
+    *b = (uint64_t) (r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    const uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t) *a, lb = (uint32_t) *b;
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/**
+ * @brief Multiplies two 64-bit integers and folds the 128-bit product into 64 bits.
+ *
+ * @param a The first factor.
+ * @param b The second factor.
+ * @return The low half of the product XORed with its high half.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline uint64_t lite_mix_(uint64_t a, uint64_t b) {
+    lite_mum_(&a, &b);
+    return a ^ b;
+}
+
+/**
+ * @brief Reads 8 bytes from an unaligned address.
+ *
+ * @param p A pointer to the bytes.
+ * @return The bytes, in native byte order.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline uint64_t lite_read64_(const unsigned char *const p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+/**
+ * @brief Reads 4 bytes from an unaligned address.
+ *
+ * @param p A pointer to the bytes.
+ * @return The bytes, in native byte order.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline uint64_t lite_read32_(const unsigned char *const p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+/**
+ * @brief Converts an ASCII uppercase character to lowercase, leaving every other byte unchanged.
+ *
+ * @param c The character to be converted.
+ * @return The lowercase character.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline unsigned char lite_fold_(const unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? c | 0x20 : c;
+}
+
+/**
+ * @brief Converts the ASCII uppercase characters in a 64-bit word to lowercase, 8 at a time.
+ *
+ * @param x The word to be converted.
+ * @return The converted word.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline uint64_t lite_fold64_(const uint64_t x) {
+    const uint64_t ones = 0x0101010101010101ull;
+    // With the top bits cleared, the additions cannot carry between bytes
+    const uint64_t low = x & 0x7F7F7F7F7F7F7F7Full;
+    const uint64_t at_least_a = low + (0x80 - 'A') * ones;
+    const uint64_t above_z = low + (0x80 - 'Z' - 1) * ones;
+    const uint64_t upper = at_least_a & ~above_z & ~x & 0x8080808080808080ull;
+    // Move each flag from bit 7 to bit 5, which is the case bit
+    return x | upper >> 2;
+}
+
+#if LITE_HAS_SSE2
+/**
+ * @brief Converts the ASCII uppercase characters in a vector to lowercase.
+ *
+ * @param v The vector to be converted.
+ * @return The converted vector.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline __m128i lite_fold_sse2_(const __m128i v) {
+    // Map 'A'..'Z' to the lowest 26 signed values, so that a single signed comparison finds them
+    const __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8((char) (0x80 - 'A')));
+    const __m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char) (-128 + 26)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif // LITE_HAS_SSE2
+
+/**
+ * @brief Finds the first position where two byte arrays differ, ignoring ASCII case.
+ *
+ * The arrays are compared 16 bytes at a time, with the case folded on the fly.
+ * Embedded null characters are compared like any other byte.
+ *
+ * @param a The first array.
+ * @param b The second array.
+ * @param n The number of bytes to be compared.
+ * @return The index of the first difference, or \p n if the arrays are equal (ignoring case).
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static size_t
+lite_case_mismatch_(const char *const restrict a, const char *const restrict b, const size_t n) {
+    size_t i = 0;
+#if LITE_HAS_SSE2
+    for (; i + 16 <= n; i += 16) {
+        const __m128i va = lite_fold_sse2_(_mm_loadu_si128((const __m128i *) (a + i)));
+        const __m128i vb = lite_fold_sse2_(_mm_loadu_si128((const __m128i *) (b + i)));
+        const unsigned diff = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) ^ 0xFFFFu;
+        if (diff) return i + lite_ctz_(diff);
+    }
+#else
+    for (; i + 8 <= n; i += 8) {
+        if (lite_fold64_(lite_read64_((const unsigned char *) a + i)) !=
+            lite_fold64_(lite_read64_((const unsigned char *) b + i)))
+            break;
+    }
+#endif // LITE_HAS_SSE2
+    for (; i < n; ++i) {
+        if (lite_fold_((unsigned char) a[i]) != lite_fold_((unsigned char) b[i])) return i;
+    }
+    return n;
+}
+
+/**
+ * @brief Compares two byte arrays for equality, ignoring ASCII case.
+ *
+ * @param a The first array.
+ * @param b The second array.
+ * @param n The number of bytes to be compared.
+ * @return true if the arrays are equal (ignoring case), false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_ALWAYS_INLINE static inline bool
+lite_case_equal_(const char *const restrict a, const char *const restrict b, const size_t n) {
+    return lite_case_mismatch_(a, b, n) == n;
+}
+
+// The reads of the hash function, with the case optionally folded
+#define LITE_HASH_READ64_(p) (fold ? lite_fold64_(lite_read64_(p)) : lite_read64_(p))
+#define LITE_HASH_READ32_(p) (fold ? lite_fold64_(lite_read32_(p)) : lite_read32_(p))
+#define LITE_HASH_BYTE_(c) (fold ? lite_fold_(c) : (c))
+
+/**
+ * @brief Hashes a buffer with a wyhash-style function.
+ *
+ * Inputs of up to 16 bytes are read with a few overlapping loads, and longer inputs are consumed
+ * 48 bytes at a time by three independent multiply-mix lanes.
+ *
+ * @param data A pointer to the buffer.
+ * @param len The size of the buffer.
+ * @param fold Whether to convert ASCII uppercase characters to lowercase as they are read.
+ * Since this is a constant in every caller, each variant is compiled without the check.
+ * @return The 64-bit hash of the buffer.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline uint64_t
+lite_hash_impl_(const void *const restrict data, const size_t len, const bool fold) {
+    static const uint64_t secret[4] = {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+    };
+    const unsigned char *p = (const unsigned char *) data;
+    uint64_t seed = lite_mix_(0x9e3779b97f4a7c15ull ^ secret[0], secret[1]);
+    uint64_t a, b;
+
+    if (len <= 16) {
+        if (len >= 4) {
+            // Two overlapping pairs of 4-byte loads cover every length from 4 to 16
+            const size_t shift = (len >> 3) << 2;
+            a = (LITE_HASH_READ32_(p) << 32) | LITE_HASH_READ32_(p + shift);
+            b = (LITE_HASH_READ32_(p + len - 4) << 32) | LITE_HASH_READ32_(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = ((uint64_t) LITE_HASH_BYTE_(p[0]) << 16) | ((uint64_t) LITE_HASH_BYTE_(p[len >> 1]) << 8) |
+                LITE_HASH_BYTE_(p[len - 1]);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = lite_mix_(LITE_HASH_READ64_(p) ^ secret[1], LITE_HASH_READ64_(p + 8) ^ seed);
+                see1 = lite_mix_(LITE_HASH_READ64_(p + 16) ^ secret[2], LITE_HASH_READ64_(p + 24) ^ see1);
+                see2 = lite_mix_(LITE_HASH_READ64_(p + 32) ^ secret[3], LITE_HASH_READ64_(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = lite_mix_(LITE_HASH_READ64_(p) ^ secret[1], LITE_HASH_READ64_(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // The last 16 bytes, which may overlap the bytes already consumed
+        a = LITE_HASH_READ64_(p + i - 16);
+        b = LITE_HASH_READ64_(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    lite_mum_(&a, &b);
+    return lite_mix_(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+#undef LITE_HASH_READ64_
+#undef LITE_HASH_READ32_
+#undef LITE_HASH_BYTE_
+
+/**
+ * @brief Hashes a buffer.
+ *
+ * @param data A pointer to the buffer.
+ * @param len The size of the buffer.
+ * @return The 64-bit hash of the buffer.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static uint64_t lite_hash_(const void *const restrict data, const size_t len) {
+    return lite_hash_impl_(data, len, false);
+}
+
+/**
+ * @brief Hashes a buffer, ignoring ASCII case.
+ *
+ * @param data A pointer to the buffer.
+ * @param len The size of the buffer.
+ * @return The 64-bit hash of the buffer with its ASCII uppercase characters converted to lowercase.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static uint64_t lite_case_hash_(const void *const restrict data, const size_t len) {
+    return lite_hash_impl_(data, len, true);
+}
+
+/**
+ * @brief Reduces a 64-bit hash to a non-zero \p size_t value.
+ *
+ * Zero is reserved for invalid strings.
+ *
+ * @param h The 64-bit hash.
+ * @return The reduced hash.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline size_t lite_hash_value_(const uint64_t h) {
+#if SIZE_MAX < UINT64_MAX
+    const size_t folded = (size_t) (h ^ (h >> 32));
+#else
+    const size_t folded = (size_t) h;
+#endif
+    return folded ? folded : 1;
+}
+
+/**
+ * @brief Computes the hash of a string.
+ *
+ * The hash is computed from the characters every time, and is not stored in the string,
+ * so a string can be hashed concurrently from several threads.
+ * The hash map stores the hashes of its own keys instead.
+ *
+ * @param s A pointer to the string.
+ * @return The hash of the string, which is never 0, or 0 if the string is invalid.
+ *
+ * @note The hash is fast but not cryptographic, and is not keyed:
+ * it should not be exposed to inputs that are chosen to collide.
+ * Its values may differ between platforms and versions of the library.
+ */
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT size_t string_hash(const lite_string *const restrict s) {
+    return s ? lite_hash_value_(lite_hash_(s->data, s->size)) : 0;
+}
+
 /**
  * @brief Compares two strings for equality.
  *
@@ -401,6 +936,9 @@ LITE_ATTR_REPRODUCIBLE bool string_compare(const lite_string *const restrict s1,
 /**
  * @brief Compares two strings for equality, ignoring case.
  *
+ * Only the ASCII letters are case-folded, independently of the locale,
+ * and all the characters are compared, including embedded null characters.
+ *
  * @param s1 A pointer to the first string.
  * @param s2 A pointer to the second string.
  * @return true if the strings are equal (ignoring case), false otherwise.
@@ -410,7 +948,44 @@ LITE_ATTR_REPRODUCIBLE bool string_case_compare(const lite_string *const restric
     if (s1 == nullptr || s2 == nullptr || s1->size != s2->size)
         return false;
 
-    return strncasecmp(s1->data, s2->data, s1->size) == 0;
+    return lite_case_equal_(s1->data, s2->data, s1->size);
+}
+
+/**
+ * @brief Compares two strings lexicographically, ignoring case.
+ *
+ * The ASCII uppercase letters are compared as their lowercase equivalents, independently of the locale.
+ * Otherwise, the order is the same as the one given by \p string_cmp()
+ *
+ * @param s1 A pointer to the first string.
+ * @param s2 A pointer to the second string.
+ * @return A negative value if the first string comes first, a positive value if the second string comes first,
+ * or 0 if the strings are equal (ignoring case). An invalid string comes before any valid string.
+ */
+LITE_ATTR_REPRODUCIBLE int string_case_cmp(const lite_string *const restrict s1, const lite_string *const restrict s2) {
+    if (s1 == nullptr || s2 == nullptr) return (s1 != nullptr) - (s2 != nullptr);
+
+    const size_t len = s1->size < s2->size ? s1->size : s2->size;
+    const size_t i = lite_case_mismatch_(s1->data, s2->data, len);
+    if (i < len) {
+        const unsigned char a = lite_fold_((unsigned char) s1->data[i]);
+        const unsigned char b = lite_fold_((unsigned char) s2->data[i]);
+        return a < b ? -1 : 1;
+    }
+    return (s1->size > s2->size) - (s1->size < s2->size);
+}
+
+/**
+ * @brief Computes the hash of a string, ignoring case.
+ *
+ * Strings that are equal according to \p string_case_compare() have the same hash.
+ * A string without ASCII uppercase letters has the same hash as with \p string_hash()
+ *
+ * @param s A pointer to the string.
+ * @return The case-insensitive hash of the string, which is never 0, or 0 if the string is invalid.
+ */
+LITE_ATTR_REPRODUCIBLE size_t string_case_hash(const lite_string *const restrict s) {
+    return s ? lite_hash_value_(lite_case_hash_(s->data, s->size)) : 0;
 }
 
 /**
@@ -449,9 +1024,13 @@ LITE_ATTR_REPRODUCIBLE size_t string_capacity(const lite_string *const restrict
  * @param s A pointer to the string.
  */
 void string_clear(lite_string *const restrict s) {
-    if (s && s->size) {
-        memset(s->data, '\0', s->size);
+    if (s && (s->size || s->offset)) {
+        // Also reclaim the space skipped by trimming
+        s->data -= s->offset;
+        s->capacity += s->offset;
+        memset(s->data, '\0', s->offset + s->size);
         s->size = 0;
+        s->offset = 0;
     }
 }
 
@@ -649,6 +1228,26 @@ bool string_append(lite_string *const restrict s1, const lite_string *const rest
     return s2 && string_append_range(s1, s2, s2->size);
 }
 
+/**
+ * @brief Appends a number of bytes to the end of a string.
+ *
+ * The length is trusted as it is, so the bytes are not scanned, and they may contain null characters.
+ *
+ * @param s A pointer to the string where the bytes will be appended.
+ * @param data A pointer to the bytes, which must not point into the string. Can be nullptr if \p len is 0.
+ * @param len The number of bytes to be appended.
+ * @return true if the bytes were successfully appended, false otherwise.
+ */
+bool string_append_mem(lite_string *const restrict s, const void *const restrict data, const size_t len) {
+    if (s == nullptr || (data == nullptr && len)) return false;
+    if (len == 0) return true;
+    if (len > SIZE_MAX - 1 - s->size || !string_reserve(s, s->size + len)) return false;
+
+    memcpy(s->data + s->size, data, len);
+    s->size += len;
+    return true;
+}
+
 /**
  * @brief Appends a specified number of characters from a C-string to a string.
  *
@@ -661,17 +1260,8 @@ bool
 string_append_cstr_range(lite_string *const restrict s, const char *const restrict cstr, const size_t count) {
     if (s) {
         if (count == 0) return true;
-        if (cstr) {
-            // Resize the string if necessary
-            if (count <= strlen(cstr)) {
-                if (string_reserve(s, s->size + count)) {
-                    // Copy the C-string into the string
-                    memcpy(s->data + s->size * sizeof(char), cstr, count * sizeof(char));
-                    s->size += count;
-                    return true;
-                }
-            }
-        }
+        // The C-string must not end within the range, which is checked without scanning past it
+        if (cstr && memchr(cstr, '\0', count) == nullptr) return string_append_mem(s, cstr, count);
     }
     return false;
 }
@@ -684,16 +1274,207 @@ string_append_cstr_range(lite_string *const restrict s, const char *const restri
  * @return true if the C-string was successfully appended, false otherwise.
  */
 bool string_append_cstr(lite_string *const restrict s, const char *const restrict cstr) {
-    return string_append_cstr_range(s, cstr, strlen(cstr));
+    return cstr && string_append_mem(s, cstr, strlen(cstr));
 }
 
 /**
- * @brief Returns a pointer to the C-string representation of a string.
+ * @brief Creates a new, empty string that can hold a given number of characters without resizing.
  *
- * @param s A pointer to the string.
- * @return A pointer to the C-string representation of the string, or nullptr if the string is invalid.
- * @note It is not recommended to modify the string's data directly. Use the provided functions instead.
- */
+ * @param size The number of characters the string must be able to hold.
+ * @return A pointer to the newly created string, or nullptr if memory allocation failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_NODISCARD static lite_string *lite_new_with_capacity_(const size_t size) {
+    if (size == SIZE_MAX) return nullptr;
+
+    size_t capacity = lite_clp2_(size + 1);
+    if (capacity < 16) capacity = 16;
+
+    lite_string *s = (lite_string *) malloc(sizeof(lite_string));
+    if (s) {
+        if ((s->data = (char *) calloc(capacity, sizeof(char)))) {
+            s->size = 0;
+            s->capacity = capacity;
+            s->offset = 0;
+            return s;
+        }
+        free(s);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Computes the length of the strings joined with a separator.
+ *
+ * @param parts An array of pointers to the strings.
+ * @param n The number of strings.
+ * @param sep_len The length of the separator.
+ * @param total A pointer to store the length of the result.
+ * @return true if the length was computed, false if a string is invalid or the length overflows.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static bool lite_join_length_(lite_string *const *const restrict parts, const size_t n,
+                              const size_t sep_len, size_t *const restrict total) {
+    size_t len = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (parts[i] == nullptr || parts[i]->size > SIZE_MAX - len) return false;
+        len += parts[i]->size;
+    }
+    if (n > 1 && sep_len > (SIZE_MAX - len) / (n - 1)) return false;
+    *total = n ? len + (n - 1) * sep_len : 0;
+    return true;
+}
+
+/**
+ * @brief Computes the length of the views joined with a separator.
+ *
+ * @param views An array of views.
+ * @param n The number of views.
+ * @param sep_len The length of the separator.
+ * @param total A pointer to store the length of the result.
+ * @return true if the length was computed, false if a view is invalid or the length overflows.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static bool lite_join_views_length_(const lite_string_view *const restrict views, const size_t n,
+                                    const size_t sep_len, size_t *const restrict total) {
+    size_t len = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if ((views[i].data == nullptr && views[i].size) || views[i].size > SIZE_MAX - len) return false;
+        len += views[i].size;
+    }
+    if (n > 1 && sep_len > (SIZE_MAX - len) / (n - 1)) return false;
+    *total = n ? len + (n - 1) * sep_len : 0;
+    return true;
+}
+
+/**
+ * @brief Appends strings, separated by a C-string, to the end of a string.
+ *
+ * The total length is computed first, so the destination is resized at most once.
+ *
+ * @param dest A pointer to the string where the strings will be appended. Must not be one of the parts.
+ * @param parts An array of pointers to the strings to be joined.
+ * @param n The number of strings.
+ * @param sep The separator to insert between consecutive strings. Can be nullptr for no separator.
+ * @return true if the strings were successfully appended, false otherwise.
+ * The destination is not modified on failure.
+ */
+bool string_append_join(lite_string *const restrict dest, lite_string *const *const restrict parts,
+                        const size_t n, const char *const restrict sep) {
+    if (dest && (parts || n == 0)) {
+        const size_t sep_len = sep ? strlen(sep) : 0;
+        size_t total;
+        if (!lite_join_length_(parts, n, sep_len, &total) || total > SIZE_MAX - dest->size) return false;
+        if (!string_reserve(dest, dest->size + total)) return false;
+
+        char *out = dest->data + dest->size;
+        for (size_t i = 0; i < n; ++i) {
+            if (i && sep_len) {
+                memcpy(out, sep, sep_len);
+                out += sep_len;
+            }
+            memcpy(out, parts[i]->data, parts[i]->size);
+            out += parts[i]->size;
+        }
+        dest->size += total;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Appends views, separated by a C-string, to the end of a string.
+ *
+ * The total length is computed first, so the destination is resized at most once.
+ *
+ * @param dest A pointer to the string where the views will be appended. The views must not point into it.
+ * @param views An array of the views to be joined.
+ * @param n The number of views.
+ * @param sep The separator to insert between consecutive views. Can be nullptr for no separator.
+ * @return true if the views were successfully appended, false otherwise.
+ * The destination is not modified on failure.
+ */
+bool string_append_join_views(lite_string *const restrict dest, const lite_string_view *const restrict views,
+                              const size_t n, const char *const restrict sep) {
+    if (dest && (views || n == 0)) {
+        const size_t sep_len = sep ? strlen(sep) : 0;
+        size_t total;
+        if (!lite_join_views_length_(views, n, sep_len, &total) || total > SIZE_MAX - dest->size) return false;
+        if (!string_reserve(dest, dest->size + total)) return false;
+
+        char *out = dest->data + dest->size;
+        for (size_t i = 0; i < n; ++i) {
+            if (i && sep_len) {
+                memcpy(out, sep, sep_len);
+                out += sep_len;
+            }
+            if (views[i].size) memcpy(out, views[i].data, views[i].size);
+            out += views[i].size;
+        }
+        dest->size += total;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Joins strings into a new string, separated by a C-string.
+ *
+ * The total length is computed first, so the new string is allocated only once.
+ *
+ * @param parts An array of pointers to the strings to be joined.
+ * @param n The number of strings.
+ * @param sep The separator to insert between consecutive strings. Can be nullptr for no separator.
+ * @return A pointer to the new string, or nullptr if a string is invalid or memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD lite_string *
+string_join(lite_string *const *const restrict parts, const size_t n, const char *const restrict sep) {
+    size_t total;
+    if ((parts || n == 0) && lite_join_length_(parts, n, sep ? strlen(sep) : 0, &total)) {
+        lite_string *s = lite_new_with_capacity_(total);
+        if (s) {
+            if (string_append_join(s, parts, n, sep)) return s;
+            string_free(s);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Joins views into a new string, separated by a C-string.
+ *
+ * The total length is computed first, so the new string is allocated only once.
+ *
+ * @param views An array of the views to be joined.
+ * @param n The number of views.
+ * @param sep The separator to insert between consecutive views. Can be nullptr for no separator.
+ * @return A pointer to the new string, or nullptr if a view is invalid or memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD lite_string *
+string_join_views(const lite_string_view *const restrict views, const size_t n, const char *const restrict sep) {
+    size_t total;
+    if ((views || n == 0) && lite_join_views_length_(views, n, sep ? strlen(sep) : 0, &total)) {
+        lite_string *s = lite_new_with_capacity_(total);
+        if (s) {
+            if (string_append_join_views(s, views, n, sep)) return s;
+            string_free(s);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Returns a pointer to the C-string representation of a string.
+ *
+ * @param s A pointer to the string.
+ * @return A pointer to the C-string representation of the string, or nullptr if the string is invalid.
+ * @note It is not recommended to modify the string's data directly. Use the provided functions instead.
+ */
 LITE_ATTR_HOT char *string_cstr(const lite_string *const restrict s) {
     if (s) {
         // Check if the string is null-terminated
@@ -727,12 +1508,26 @@ LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT char *string_data(const lite_string *const
  */
 LITE_ATTR_REPRODUCIBLE bool string_compare_cstr(const lite_string *const restrict s, const char *const restrict cstr) {
     if (s && cstr) {
-        if (s->size == strlen(cstr))
+        // The C-string is only scanned as far as the length of the string, instead of to its end
+        if (memchr(cstr, '\0', s->size) == nullptr && cstr[s->size] == '\0')
             return memcmp(s->data, cstr, s->size) == 0;
     }
     return false;
 }
 
+/**
+ * @brief Compares a string with a number of bytes for equality.
+ *
+ * @param s A pointer to the string.
+ * @param data A pointer to the bytes, which may contain null characters. Can be nullptr if \p len is 0.
+ * @param len The number of bytes.
+ * @return true if the string has exactly the given bytes, false otherwise.
+ */
+LITE_ATTR_REPRODUCIBLE bool
+string_compare_mem(const lite_string *const restrict s, const void *const restrict data, const size_t len) {
+    return s && (data || len == 0) && s->size == len && (len == 0 || memcmp(s->data, data, len) == 0);
+}
+
 /**
  * @brief Compares a string with a C-string for equality, ignoring case.
  *
@@ -743,17 +1538,8 @@ LITE_ATTR_REPRODUCIBLE bool string_compare_cstr(const lite_string *const restric
 LITE_ATTR_REPRODUCIBLE bool
 string_case_compare_cstr(const lite_string *const restrict s, const char *const restrict cstr) {
     if (s && cstr) {
-        if (s->size == strlen(cstr)) {
-#if HAS_STRNCASECMP
-            return strncasecmp(s->data, cstr, s->size) == 0;
-#else
-            for (size_t i = 0; i < s->size; ++i) {
-                if (tolower((unsigned char) s->data[i]) != tolower((unsigned char) cstr[i]))
-                    return false;
-            }
-            return true;
-#endif
-        }
+        if (memchr(cstr, '\0', s->size) == nullptr && cstr[s->size] == '\0')
+            return lite_case_equal_(s->data, cstr, s->size);
     }
     return false;
 }
@@ -1124,6 +1910,32 @@ kmp_search(const char *const restrict s, const size_t s_size, const char *const
 }
 
 
+/**
+ * @brief Finds the first occurrence of a byte pattern in a text.
+ *
+ * Uses \p memmem() where available, and the KMP algorithm otherwise.
+ *
+ * @param text The text to be searched.
+ * @param text_len The length of the text.
+ * @param pattern The pattern to be found.
+ * @param pattern_len The length of the pattern, which must not be zero.
+ * @return The index of the first occurrence of the pattern in the text,
+ * or \p lite_string_npos if the pattern was not found.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_ALWAYS_INLINE static inline size_t
+lite_find_mem_(const char *const restrict text, const size_t text_len,
+               const char *const restrict pattern, const size_t pattern_len) {
+    if (pattern_len > text_len) return lite_string_npos;
+#if defined(_GNU_SOURCE) && !(defined(_WIN32) || defined(WIN32) || _MSC_VER)
+    const char *found = (const char *) memmem(text, text_len, pattern, pattern_len);
+    return found ? (size_t) (found - text) : lite_string_npos;
+#else
+    return kmp_search(text, text_len, pattern, pattern_len);
+#endif
+}
+
 /**
  * @brief Finds the first occurrence of a substring in a string, starting from a specified index.
  *
@@ -1138,14 +1950,10 @@ string_find_from(const lite_string *const restrict s, const lite_string *const r
     if (s && sub && start < s->size) {
         if (sub->size == 0) return start;
         if (sub->size > s->size) return lite_string_npos;
-#if defined(_GNU_SOURCE) && !(defined(_WIN32) || defined(WIN32) || _MSC_VER)
-        const char *found = (const char *) memmem(s->data + start, s->size - start, sub->data, sub->size);
-        if (found) return found - s->data;
-#else
-        const size_t index = kmp_search(s->data + start, s->size - start, sub->data, sub->size);
+
+        const size_t index = lite_find_mem_(s->data + start, s->size - start, sub->data, sub->size);
         if (index != lite_string_npos)
             return index + start;
-#endif
     }
     return lite_string_npos;
 }
@@ -1235,15 +2043,10 @@ string_find_cstr_from(const lite_string *const restrict s, const char *const res
 
         // The search must start from a valid index
         if (start < s->size) {
-#if defined(_GNU_SOURCE) && !(defined(_WIN32) || defined(WIN32) || _MSC_VER)
-            const char *found = (const char *) memmem(s->data + start, s->size - start, cstr, len);
-            if (found) return found - s->data;
-#else
             // Search for the C-string in the string
-            const size_t index = kmp_search(s->data + start, s->size - start, cstr, len);
+            const size_t index = lite_find_mem_(s->data + start, s->size - start, cstr, len);
             if (index != lite_string_npos)
                 return index + start;
-#endif
         }
     }
     // The C-string was not found
@@ -1338,494 +2141,5333 @@ LITE_ATTR_REPRODUCIBLE bool string_contains_cstr(const lite_string *const restri
 }
 
 /**
- * @brief Checks if a string starts with a specified substring.
+ * @brief Finds the first occurrence of a pattern in a text, ignoring ASCII case.
+ *
+ * Candidate positions are found by comparing the first and the last byte of the pattern
+ * against 16 positions of the text at a time, with the case folded on the fly.
+ * Only the candidates are compared in full, and neither the text nor the pattern is copied.
+ *
+ * @param text The text to be searched.
+ * @param text_len The length of the text.
+ * @param pattern The pattern to be found.
+ * @param pattern_len The length of the pattern, which must not be zero.
+ * @return The index of the first occurrence of the pattern, or \p lite_string_npos if it was not found.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT static size_t
+lite_find_case_(const char *const restrict text, const size_t text_len,
+                const char *const restrict pattern, const size_t pattern_len) {
+    if (pattern_len > text_len) return lite_string_npos;
+
+    const unsigned char first = lite_fold_((unsigned char) pattern[0]);
+    const unsigned char last = lite_fold_((unsigned char) pattern[pattern_len - 1]);
+    const size_t end = text_len - pattern_len + 1; // One past the last possible start
+    size_t i = 0;
+
+#if LITE_HAS_SSE2
+    const __m128i vfirst = _mm_set1_epi8((char) first);
+    const __m128i vlast = _mm_set1_epi8((char) last);
+
+    for (; i + 16 <= end; i += 16) {
+        const __m128i block_first = lite_fold_sse2_(_mm_loadu_si128((const __m128i *) (text + i)));
+        const __m128i block_last = lite_fold_sse2_(_mm_loadu_si128((const __m128i *) (text + i + pattern_len - 1)));
+
+        unsigned mask = (unsigned) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, vfirst),
+                                                                   _mm_cmpeq_epi8(block_last, vlast)));
+        while (mask) {
+            const size_t pos = i + lite_ctz_(mask);
+            if (lite_case_equal_(text + pos + 1, pattern + 1, pattern_len - 1)) return pos;
+            mask &= mask - 1;
+        }
+    }
+#endif // LITE_HAS_SSE2
+
+    for (; i < end; ++i) {
+        if (lite_fold_((unsigned char) text[i]) == first &&
+            lite_fold_((unsigned char) text[i + pattern_len - 1]) == last &&
+            lite_case_equal_(text + i + 1, pattern + 1, pattern_len - 1))
+            return i;
+    }
+    return lite_string_npos;
+}
+
+/**
+ * @brief Finds the first occurrence of a substring in a string, ignoring case.
+ *
+ * Only ASCII letters are folded. The string is never copied or modified.
  *
  * @param s A pointer to the string.
- * @param sub A pointer to the substring to be checked.
- * @return True if the string starts with the substring, false otherwise.
+ * @param sub A pointer to the substring to be found.
+ * @return The index of the first occurrence of the substring in the string (ignoring case),
+ * or \p lite_string_npos if the substring was not found.
  */
-LITE_ATTR_REPRODUCIBLE bool
-string_starts_with(const lite_string *const restrict s, const lite_string *const restrict sub) {
-    return string_find(s, sub) == 0;
+LITE_ATTR_REPRODUCIBLE size_t
+string_find_case(const lite_string *const restrict s, const lite_string *const restrict sub) {
+    if (s && sub && s->size) {
+        if (sub->size == 0) return 0;
+        return lite_find_case_(s->data, s->size, sub->data, sub->size);
+    }
+    return lite_string_npos;
 }
 
 /**
- * @brief Checks if a string starts with a specified C-string.
+ * @brief Finds the first occurrence of a C-string in a string, ignoring case.
+ *
+ * Only ASCII letters are folded. The string is never copied or modified.
  *
  * @param s A pointer to the string.
- * @param cstr The C-string to be checked.
- * @return True if the string starts with the C-string, false otherwise.
+ * @param cstr The C-string to be found.
+ * @return The index of the first occurrence of the C-string in the string (ignoring case),
+ * or \p lite_string_npos if the C-string was not found.
  */
-LITE_ATTR_REPRODUCIBLE bool
-string_starts_with_cstr(const lite_string *const restrict s, const char *const restrict cstr) {
-    return string_find_cstr(s, cstr) == 0;
+LITE_ATTR_REPRODUCIBLE size_t
+string_find_case_cstr(const lite_string *const restrict s, const char *const restrict cstr) {
+    if (s && cstr) {
+        const size_t len = strlen(cstr);
+        if (len == 0) return 0;
+        return lite_find_case_(s->data, s->size, cstr, len);
+    }
+    return lite_string_npos;
 }
 
 /**
- * @brief Checks if a string ends with a specified substring.
+ * @brief Checks if a string contains a specified substring, ignoring case.
  *
  * @param s A pointer to the string.
- * @param sub A pointer to the substring to be checked.
- * @return True if the string ends with the substring, false otherwise.
+ * @param sub A pointer to the substring to be found.
+ * @return True if the string contains the substring (ignoring case), false otherwise.
  */
 LITE_ATTR_REPRODUCIBLE bool
-string_ends_with(const lite_string *const restrict s, const lite_string *const restrict sub) {
-    return s && sub && string_rfind(s, sub) == s->size - sub->size;
+string_contains_case(const lite_string *const restrict s, const lite_string *const restrict sub) {
+    return string_find_case(s, sub) != lite_string_npos;
 }
 
 /**
- * @brief Checks if a string ends with a specified C-string.
+ * @brief Checks if a string contains a specified C-string, ignoring case.
  *
  * @param s A pointer to the string.
- * @param cstr The C-string to be checked.
- * @return True if the string ends with the C-string, false otherwise.
+ * @param cstr The C-string to be found.
+ * @return True if the string contains the C-string (ignoring case), false otherwise.
  */
 LITE_ATTR_REPRODUCIBLE bool
-string_ends_with_cstr(const lite_string *const restrict s, const char *const restrict cstr) {
-    return s && cstr && string_rfind_cstr(s, cstr) == s->size - strlen(cstr);
+string_contains_case_cstr(const lite_string *const restrict s, const char *const restrict cstr) {
+    return string_find_case_cstr(s, cstr) != lite_string_npos;
 }
 
-
 /**
- * @brief Shrinks the string to a specified size.
+ * @brief Counts the occurrences of a byte in a range of bytes.
  *
- * @param s A pointer to the string to be shrunk.
- * @param size The new size for the string.
- * @return true if the string was successfully shrunk, false otherwise.
+ * @param data A pointer to the bytes.
+ * @param len The number of bytes.
+ * @param c The byte to count.
+ * @return The number of occurrences.
  *
- * @note Extra characters are removed from the end of the string.
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-bool string_shrink(lite_string *const restrict s, const size_t size) {
-    if (s && size < s->size) {
-        s->size = size;
-        s->data[size] = '\0';
-        return true;
+LITE_ATTR_REPRODUCIBLE static size_t lite_count_byte_(const char *const restrict data, const size_t len, const char c) {
+    size_t count = 0, i = 0;
+#if LITE_HAS_SSE2
+    const __m128i needle = _mm_set1_epi8(c);
+    while (i + 16 <= len) {
+        // Each byte lane counts up to 255 blocks before the lanes are summed
+        __m128i lanes = _mm_setzero_si128();
+        const size_t blocks = (len - i) / 16 < 255 ? (len - i) / 16 : 255;
+        for (size_t b = 0; b < blocks; ++b, i += 16) {
+            const __m128i block = _mm_loadu_si128((const __m128i *) (data + i));
+            lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(block, needle));
+        }
+        count += lite_sum_lanes_sse2_(lanes);
     }
-    return false;
+#endif // LITE_HAS_SSE2
+    for (; i < len; ++i) count += data[i] == c;
+    return count;
 }
 
 /**
- * @brief Shrinks the string to fit its size.
+ * @brief Counts the occurrences of a character in a string.
  *
- * @param s A pointer to the string to be shrunk.
- * @return true if the string was successfully shrunk or if shrinking was unnecessary, false otherwise.
+ * The string is compared 16 characters at a time, and the matches are summed in vector lanes,
+ * so the cost does not depend on the number of occurrences.
+ *
+ * @param s A pointer to the string.
+ * @param c The character to be counted. It can be the null character.
+ * @return The number of occurrences, or \p lite_string_npos if the string is invalid.
  */
-bool string_shrink_to_fit(lite_string *const restrict s) {
-    if (s) {
-        // If the string is empty, or if the size is equal to the capacity, no resizing is necessary
-        if (!s->size || s->size == s->capacity) return true;
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT size_t string_count_char(const lite_string *const restrict s, const char c) {
+    return s ? lite_count_byte_(s->data, s->size, c) : lite_string_npos;
+}
 
-        char *temp = (char *) realloc(s->data, s->size * sizeof(char));
-        if (temp) {
-            s->data = temp;
-            s->capacity = s->size;
-            return true;
+/**
+ * @brief Counts the characters of a string that belong to a set.
+ *
+ * @param s A pointer to the string.
+ * @param chars The C-string containing the characters to be counted. If empty, nothing is counted.
+ * @return The number of characters of the string that appear in \p chars,
+ * or \p lite_string_npos if an argument is invalid.
+ */
+LITE_ATTR_REPRODUCIBLE size_t
+string_count_chars(const lite_string *const restrict s, const char *const restrict chars) {
+    if (s == nullptr || chars == nullptr) return lite_string_npos;
+
+    bool lookup[256] = {false};
+    LITE_ATTR_MAYBE_UNUSED unsigned char members[LITE_SMALL_SET];
+    size_t member_count = 0;
+    for (const char *p = chars; *p; ++p) {
+        const unsigned char c = (unsigned char) *p;
+        if (!lookup[c]) {
+            if (member_count < LITE_SMALL_SET) members[member_count] = c;
+            ++member_count;
+            lookup[c] = true;
         }
     }
-    return false;
+    if (member_count == 1) return lite_count_byte_(s->data, s->size, (char) members[0]);
+
+    size_t count = 0, i = 0;
+#if LITE_HAS_SSE2
+    if (member_count > 1 && member_count <= LITE_SMALL_SET) {
+        __m128i set[LITE_SMALL_SET];
+        for (size_t k = 0; k < member_count; ++k) set[k] = _mm_set1_epi8((char) members[k]);
+
+        while (i + 16 <= s->size) {
+            // Each byte lane counts up to 255 blocks before the lanes are summed
+            __m128i lanes = _mm_setzero_si128();
+            const size_t blocks = (s->size - i) / 16 < 255 ? (s->size - i) / 16 : 255;
+            for (size_t b = 0; b < blocks; ++b, i += 16) {
+                const __m128i block = _mm_loadu_si128((const __m128i *) (s->data + i));
+                __m128i hits = _mm_setzero_si128();
+                for (size_t k = 0; k < member_count; ++k) hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, set[k]));
+                lanes = _mm_sub_epi8(lanes, hits);
+            }
+            count += lite_sum_lanes_sse2_(lanes);
+        }
+    }
+#endif // LITE_HAS_SSE2
+    if (member_count)
+        for (; i < s->size; ++i) count += lookup[(unsigned char) s->data[i]];
+    return count;
 }
 
 /**
- * @brief Converts all the uppercase characters in a string to lowercase.
+ * @brief Counts the occurrences of a pattern in a range of characters.
  *
- * @param s A pointer to the string to be converted to lowercase.
+ * @param data The characters to be searched.
+ * @param size The number of characters.
+ * @param pattern The pattern to be counted.
+ * @param len The length of the pattern, which must not be zero.
+ * @param overlapping Whether an occurrence may start inside the previous one.
+ * @return The number of occurrences.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-void string_to_lower(const lite_string *const restrict s) {
-    if (s) {
-        for (size_t i = 0; i < s->size; ++i) {
-            if (s->data[i] >= 'A' && s->data[i] <= 'Z')
-                s->data[i] += 32;
-        }
+LITE_ATTR_REPRODUCIBLE static size_t lite_count_mem_(const char *const restrict data, const size_t size,
+                                                     const char *const restrict pattern, const size_t len,
+                                                     const bool overlapping) {
+    // A single character cannot overlap itself, and is counted without searching for each occurrence
+    if (len == 1) return lite_count_byte_(data, size, pattern[0]);
+
+    size_t count = 0, pos = 0;
+    const size_t step = overlapping ? 1 : len;
+    while (size - pos >= len) {
+        const size_t index = lite_find_mem_(data + pos, size - pos, pattern, len);
+        if (index == lite_string_npos) break;
+        pos += index + step;
+        ++count;
     }
+    return count;
 }
 
 /**
- * @brief Converts all the lowercase characters in a string to uppercase.
+ * @brief Counts the occurrences of a substring in a string.
  *
- * @param s A pointer to the string to be converted to uppercase.
+ * @param s A pointer to the string.
+ * @param sub A pointer to the substring to be counted. It must not be empty.
+ * @param overlapping Whether overlapping occurrences are all counted. Otherwise, the string is scanned
+ * from left to right, and the search resumes after the end of each occurrence, like in \p string_replace().
+ * @return The number of occurrences, or \p lite_string_npos if an argument is invalid.
  */
-void string_to_upper(const lite_string *const restrict s) {
-    if (s) {
-        for (size_t i = 0; i < s->size; ++i) {
-            if (s->data[i] >= 'a' && s->data[i] <= 'z')
-                s->data[i] -= 32;
-        }
-    }
+LITE_ATTR_REPRODUCIBLE size_t string_count(const lite_string *const restrict s, const lite_string *const restrict sub,
+                                           const bool overlapping) {
+    if (s && sub && sub->size) return lite_count_mem_(s->data, s->size, sub->data, sub->size, overlapping);
+    return lite_string_npos;
 }
 
 /**
- * @brief Converts a string to title case.
+ * @brief Counts the occurrences of a C-string in a string.
  *
- * @param s A pointer to the string to be converted to title case.
+ * @param s A pointer to the string.
+ * @param cstr The C-string to be counted. It must not be empty.
+ * @param overlapping Whether overlapping occurrences are all counted.
+ * @return The number of occurrences, or \p lite_string_npos if an argument is invalid.
+ *
+ * @see string_count()
  */
-void string_to_title(const lite_string *const restrict s) {
-    if (s) {
-        if (s->data[0] >= 'a' && s->data[0] <= 'z')
-            s->data[0] -= 32;
+LITE_ATTR_REPRODUCIBLE size_t string_count_cstr(const lite_string *const restrict s, const char *const restrict cstr,
+                                                const bool overlapping) {
+    if (s && cstr && *cstr) return lite_count_mem_(s->data, s->size, cstr, strlen(cstr), overlapping);
+    return lite_string_npos;
+}
 
-        // Iterate over the rest of the string
-        for (size_t i = 1; i < s->size; ++i) {
-            if (s->data[i] == ' ' && s->data[i + 1] >= 'a' && s->data[i + 1] <= 'z')
-                s->data[i + 1] -= 32;
+/**
+ * @brief Records a field found by a split function.
+ *
+ * @param data The string being split.
+ * @param start The index of the first character of the field.
+ * @param end The index one past the last character of the field.
+ * @param views The array where the fields are stored.
+ * @param max The capacity of the array.
+ * @param keep_empty Whether empty fields are recorded.
+ * @param count A pointer to the number of fields found so far.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline void
+lite_emit_view_(const char *const restrict data, const size_t start, const size_t end,
+                lite_string_view *const restrict views, const size_t max, const bool keep_empty,
+                size_t *const restrict count) {
+    if (end > start || keep_empty) {
+        if (*count < max) {
+            views[*count].data = data + start;
+            views[*count].size = end - start;
         }
+        ++*count;
     }
 }
 
 /**
- * @brief Replaces all occurrences of a substring in a string with another substring.
+ * @brief Splits a byte array into fields separated by any byte from a set.
  *
- * @param s A pointer to the string where the substrings will be replaced.
- * @param old_sub A pointer to the substring to be replaced.
- * @param new_sub A pointer to the substring that will replace the old substring.
- * @return true if the substrings were successfully replaced, false otherwise.
+ * @param data The bytes to be split.
+ * @param size The number of bytes.
+ * @param is_delim A lookup table of the delimiters.
+ * @param members The delimiters, if there are at most \p LITE_SMALL_SET of them.
+ * @param member_count The number of delimiters.
+ * @param views The array where the fields will be stored.
+ * @param max The capacity of the array.
+ * @param keep_empty Whether empty fields are kept.
+ * @return The total number of fields.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-bool string_replace(lite_string *const restrict s, const lite_string *const restrict old_sub,
-                    const lite_string *const restrict new_sub) {
-    if (s && old_sub && new_sub) {
-        if (old_sub->size == 0) return true;
-        if (old_sub->size > s->size) return false;
+LITE_ATTR_HOT static size_t
+lite_split_set_(const char *const restrict data, const size_t size, const bool *const restrict is_delim,
+                LITE_ATTR_MAYBE_UNUSED const unsigned char *const restrict members,
+                LITE_ATTR_MAYBE_UNUSED const size_t member_count,
+                lite_string_view *const restrict views, const size_t max, const bool keep_empty) {
+    size_t count = 0, field_start = 0, i = 0;
+
+#if LITE_HAS_SSE2
+    if (member_count <= LITE_SMALL_SET) {
+        __m128i set[LITE_SMALL_SET];
+        for (size_t k = 0; k < member_count; ++k) set[k] = _mm_set1_epi8((char) members[k]);
+
+        // Locate the delimiters 16 bytes at a time
+        for (; i + 16 <= size; i += 16) {
+            unsigned mask = lite_small_set_mask_(_mm_loadu_si128((const __m128i *) (data + i)), set, member_count);
+            while (mask) {
+                const size_t pos = i + lite_ctz_(mask);
+                lite_emit_view_(data, field_start, pos, views, max, keep_empty, &count);
+                field_start = pos + 1;
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif // LITE_HAS_SSE2
 
-        size_t count = 0;
-        size_t start = 0;
-        while ((start = string_find_from(s, old_sub, start)) != lite_string_npos) {
-            if (string_erase_range(s, start, old_sub->size)) {
-                if (!string_insert_range(s, new_sub, start, new_sub->size)) return false;
-                start += new_sub->size;
-                ++count;
+    for (; i < size; ++i) {
+        if (is_delim[(unsigned char) data[i]]) {
+            lite_emit_view_(data, field_start, i, views, max, keep_empty, &count);
+            field_start = i + 1;
+        }
+    }
+    lite_emit_view_(data, field_start, size, views, max, keep_empty, &count);
+    return count;
+}
+
+/**
+ * @brief Splits a string into fields separated by a character, without copying.
+ *
+ * The fields are returned as views into the string, which remain valid until the string is modified or freed.\n
+ * At most \p max fields are stored, but all the fields are counted,
+ * so the function can be called again with a larger array if needed.
+ *
+ * @param s A pointer to the string to be split.
+ * @param delim The delimiter.
+ * @param views A pointer to the array where the fields will be stored. Can be nullptr if \p max is 0.
+ * @param max The maximum number of fields to store.
+ * @param keep_empty Whether empty fields (between adjacent delimiters, or at the ends) are kept.
+ * @return The total number of fields, or \p lite_string_npos if the arguments are invalid.
+ */
+LITE_ATTR_HOT size_t string_split(const lite_string *const restrict s, const char delim,
+                                  lite_string_view *const restrict views, const size_t max, const bool keep_empty) {
+    if (s && (views || max == 0)) {
+        bool is_delim[256] = {false};
+        is_delim[(unsigned char) delim] = true;
+        const unsigned char member = (unsigned char) delim;
+
+        return lite_split_set_(s->data, s->size, is_delim, &member, 1, views, max, keep_empty);
+    }
+    return lite_string_npos;
+}
+
+/**
+ * @brief Splits a string into fields separated by any character from a set, without copying.
+ *
+ * @param s A pointer to the string to be split.
+ * @param delims The delimiters. If empty, the whole string is a single field.
+ * @param views A pointer to the array where the fields will be stored. Can be nullptr if \p max is 0.
+ * @param max The maximum number of fields to store.
+ * @param keep_empty Whether empty fields (between adjacent delimiters, or at the ends) are kept.
+ * @return The total number of fields, or \p lite_string_npos if the arguments are invalid.
+ *
+ * @see string_split()
+ */
+LITE_ATTR_HOT size_t string_split_chars(const lite_string *const restrict s, const char *const restrict delims,
+                                        lite_string_view *const restrict views, const size_t max,
+                                        const bool keep_empty) {
+    if (s && delims && (views || max == 0)) {
+        bool is_delim[256] = {false};
+        unsigned char members[LITE_SMALL_SET];
+        size_t member_count = 0;
+
+        for (const char *p = delims; *p; ++p) {
+            const unsigned char c = (unsigned char) *p;
+            if (!is_delim[c]) {
+                if (member_count < LITE_SMALL_SET) members[member_count] = c;
+                ++member_count;
+                is_delim[c] = true;
             }
         }
-        return count > 0;
+        return lite_split_set_(s->data, s->size, is_delim, members, member_count, views, max, keep_empty);
     }
-    return false;
+    return lite_string_npos;
+}
+
+/**
+ * @brief Splits a string into fields separated by a C-string, without copying.
+ *
+ * @param s A pointer to the string to be split.
+ * @param sep The separator, which must not be empty.
+ * @param views A pointer to the array where the fields will be stored. Can be nullptr if \p max is 0.
+ * @param max The maximum number of fields to store.
+ * @param keep_empty Whether empty fields (between adjacent separators, or at the ends) are kept.
+ * @return The total number of fields, or \p lite_string_npos if the arguments are invalid.
+ *
+ * @see string_split()
+ */
+LITE_ATTR_HOT size_t string_split_cstr(const lite_string *const restrict s, const char *const restrict sep,
+                                       lite_string_view *const restrict views, const size_t max,
+                                       const bool keep_empty) {
+    if (s && sep && *sep && (views || max == 0)) {
+        const size_t len = strlen(sep);
+        size_t count = 0, field_start = 0;
+
+        while (field_start + len <= s->size) {
+            const size_t index = lite_find_mem_(s->data + field_start, s->size - field_start, sep, len);
+            if (index == lite_string_npos) break;
+
+            lite_emit_view_(s->data, field_start, field_start + index, views, max, keep_empty, &count);
+            field_start += index + len;
+        }
+        lite_emit_view_(s->data, field_start, s->size, views, max, keep_empty, &count);
+        return count;
+    }
+    return lite_string_npos;
 }
 
+/**
+ * @brief Checks if a string starts with a specified substring.
+ *
+ * @param s A pointer to the string.
+ * @param sub A pointer to the substring to be checked.
+ * @return True if the string starts with the substring, false otherwise.
+ */
+LITE_ATTR_REPRODUCIBLE bool
+string_starts_with(const lite_string *const restrict s, const lite_string *const restrict sub) {
+    return string_find(s, sub) == 0;
+}
 
 /**
- * @brief Replaces all occurrences of a character in a string with another character.
+ * @brief Checks if a string starts with a specified C-string.
  *
- * @param s A pointer to the string where the characters will be replaced.
- * @param old_char The character to be replaced.
- * @param new_char The character to replace the old character.
+ * @param s A pointer to the string.
+ * @param cstr The C-string to be checked.
+ * @return True if the string starts with the C-string, false otherwise.
  */
-void string_replace_char(const lite_string *const restrict s, const char old_char, const char new_char) {
-    if (s && old_char != new_char) {
-        for (size_t i = 0; i < s->size; ++i) {
-            if (s->data[i] == old_char)
-                s->data[i] = new_char;
+LITE_ATTR_REPRODUCIBLE bool
+string_starts_with_cstr(const lite_string *const restrict s, const char *const restrict cstr) {
+    return string_find_cstr(s, cstr) == 0;
+}
+
+/**
+ * @brief Checks if a string ends with a specified substring.
+ *
+ * @param s A pointer to the string.
+ * @param sub A pointer to the substring to be checked.
+ * @return True if the string ends with the substring, false otherwise.
+ */
+LITE_ATTR_REPRODUCIBLE bool
+string_ends_with(const lite_string *const restrict s, const lite_string *const restrict sub) {
+    return s && sub && string_rfind(s, sub) == s->size - sub->size;
+}
+
+/**
+ * @brief Checks if a string ends with a specified C-string.
+ *
+ * @param s A pointer to the string.
+ * @param cstr The C-string to be checked.
+ * @return True if the string ends with the C-string, false otherwise.
+ */
+LITE_ATTR_REPRODUCIBLE bool
+string_ends_with_cstr(const lite_string *const restrict s, const char *const restrict cstr) {
+    return s && cstr && string_rfind_cstr(s, cstr) == s->size - strlen(cstr);
+}
+
+
+/**
+ * @brief A set of patterns compiled into an Aho-Corasick automaton.
+ *
+ * The automaton is stored as a full DFA over byte classes: bytes that do not occur
+ * in any pattern share a single class, so the transition table only has one column
+ * per distinct pattern byte (plus one), which keeps it compact for large keyword sets.
+ */
+struct lite_multi_pattern {
+    uint32_t *transitions; ///< The transition table, indexed by <tt>state * class_count + class</tt>.
+    uint32_t *match; ///< The first pattern ending at each state, or \p UINT32_MAX if none.
+    uint32_t *dict_link; ///< The nearest state on the failure chain that ends a pattern, or 0 if none.
+    uint32_t *next_same; ///< The next pattern with the same bytes as a given pattern, or \p UINT32_MAX if none.
+    size_t *lengths; ///< The length of each pattern.
+    size_t pattern_count; ///< The number of patterns.
+    size_t state_count; ///< The number of states in the automaton.
+    size_t class_count; ///< The number of byte classes.
+    size_t max_length; ///< The length of the longest pattern.
+    unsigned char classes[256]; ///< The byte class of each byte value.
+    bool first_byte[256]; ///< Whether a byte value starts at least one pattern.
+    unsigned char single_first; ///< The only first byte, if \p first_count is 1.
+    size_t first_count; ///< The number of distinct first bytes.
+};
+
+/**
+ * @brief Builds an Aho-Corasick automaton from a list of patterns.
+ *
+ * @param patterns The pattern bytes.
+ * @param lengths The length of each pattern.
+ * @param count The number of patterns.
+ * @return A pointer to the new automaton, or nullptr if a pattern is empty or memory allocation failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static lite_multi_pattern *
+multi_pattern_build_(const char *const *const restrict patterns, const size_t *const restrict lengths,
+                     const size_t count) {
+    // Compute the number of states needed for the trie, and reject empty patterns
+    size_t max_states = 1;
+    for (size_t i = 0; i < count; ++i) {
+        if (patterns[i] == nullptr || lengths[i] == 0) return nullptr;
+        max_states += lengths[i];
+        if (max_states >= UINT32_MAX || count >= UINT32_MAX) return nullptr;
+    }
+
+    lite_multi_pattern *mp = (lite_multi_pattern *) calloc(1, sizeof(lite_multi_pattern));
+    if (mp == nullptr) return nullptr;
+
+    // Assign a class to every byte that occurs in a pattern. All the other bytes share class 0.
+    bool used[256] = {false};
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < lengths[i]; ++j)
+            used[(unsigned char) patterns[i][j]] = true;
+
+        const unsigned char first = (unsigned char) patterns[i][0];
+        if (!mp->first_byte[first]) {
+            mp->first_byte[first] = true;
+            mp->single_first = first;
+            ++mp->first_count;
+        }
+        if (lengths[i] > mp->max_length) mp->max_length = lengths[i];
+    }
+    mp->class_count = 1;
+    for (size_t b = 0; b < 256; ++b) {
+        if (used[b]) mp->classes[b] = (unsigned char) mp->class_count++;
+    }
+    const size_t cc = mp->class_count;
+
+    mp->pattern_count = count;
+    mp->transitions = (uint32_t *) calloc(max_states * cc, sizeof(uint32_t));
+    mp->match = (uint32_t *) malloc(max_states * sizeof(uint32_t));
+    mp->dict_link = (uint32_t *) calloc(max_states, sizeof(uint32_t));
+    mp->next_same = (uint32_t *) malloc(count * sizeof(uint32_t));
+    mp->lengths = (size_t *) malloc(count * sizeof(size_t));
+    uint32_t *fail = (uint32_t *) calloc(max_states, sizeof(uint32_t));
+    uint32_t *queue = (uint32_t *) malloc(max_states * sizeof(uint32_t));
+
+    if (!mp->transitions || !mp->match || !mp->dict_link || !mp->next_same || !mp->lengths || !fail || !queue) {
+        free(fail);
+        free(queue);
+        multi_pattern_free(mp);
+        return nullptr;
+    }
+    memset(mp->match, 0xFF, max_states * sizeof(uint32_t));
+
+    // Build the trie. A zero transition means "no edge", since no edge ever leads back to the root.
+    size_t states = 1;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t state = 0;
+        for (size_t j = 0; j < lengths[i]; ++j) {
+            uint32_t *edge = &mp->transitions[state * cc + mp->classes[(unsigned char) patterns[i][j]]];
+            if (*edge == 0) *edge = (uint32_t) states++;
+            state = *edge;
+        }
+        // Chain duplicate patterns, keeping them in insertion order
+        mp->lengths[i] = lengths[i];
+        mp->next_same[i] = UINT32_MAX;
+        if (mp->match[state] == UINT32_MAX) {
+            mp->match[state] = (uint32_t) i;
+        } else {
+            uint32_t last = mp->match[state];
+            while (mp->next_same[last] != UINT32_MAX) last = mp->next_same[last];
+            mp->next_same[last] = (uint32_t) i;
+        }
+    }
+    mp->state_count = states;
+
+    // Compute the failure links breadth-first, and turn the trie into a complete DFA
+    size_t head = 0, tail = 0;
+    for (size_t c = 0; c < cc; ++c) {
+        const uint32_t child = mp->transitions[c];
+        if (child) queue[tail++] = child;
+    }
+    while (head < tail) {
+        const uint32_t u = queue[head++];
+        for (size_t c = 0; c < cc; ++c) {
+            uint32_t *edge = &mp->transitions[u * cc + c];
+            const uint32_t target = mp->transitions[fail[u] * cc + c];
+            if (*edge) {
+                const uint32_t v = *edge;
+                fail[v] = target;
+                mp->dict_link[v] = mp->match[target] != UINT32_MAX ? target : mp->dict_link[target];
+                queue[tail++] = v;
+            } else {
+                *edge = target;
+            }
         }
     }
+    free(fail);
+    free(queue);
+
+    // Release the states that were not needed
+    if (states < max_states) {
+        void *temp = realloc(mp->transitions, states * cc * sizeof(uint32_t));
+        if (temp) mp->transitions = (uint32_t *) temp;
+    }
+    return mp;
 }
 
 /**
- * @brief Replaces all occurrences of a C-string in a string with another C-string.
+ * @brief Compiles a list of strings into a multi-pattern matcher.
  *
- * @param s A pointer to the string where the C-strings will be replaced.
- * @param old_cstr The C-string to be replaced.
- * @param new_cstr The C-string that will replace the old C-string.
- * @return true if the C-strings were successfully replaced, false otherwise.
+ * The matcher finds all the patterns in a single pass over the text,
+ * regardless of the number of patterns.
+ *
+ * @param patterns An array of pointers to the patterns.
+ * @param count The number of patterns.
+ * @return A pointer to the new matcher, or nullptr if a pattern is invalid or empty,
+ * or if memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p multi_pattern_free()
  */
-bool string_replace_cstr(lite_string *const restrict s, const char *const restrict old_cstr,
-                         const char *const restrict new_cstr) {
-    if (s && old_cstr && new_cstr) {
-        const size_t old_len = strlen(old_cstr);
-        const size_t new_len = strlen(new_cstr);
-        if (old_len == 0) return true;
-        if (old_len > s->size) return false;
+LITE_ATTR_NODISCARD lite_multi_pattern *
+multi_pattern_new(lite_string *const *const restrict patterns, const size_t count) {
+    if (patterns == nullptr || count == 0) return nullptr;
+
+    const char **data = (const char **) malloc(count * sizeof(char *));
+    size_t *lengths = (size_t *) malloc(count * sizeof(size_t));
+    lite_multi_pattern *mp = nullptr;
+
+    if (data && lengths) {
+        size_t i = 0;
+        for (; i < count && patterns[i]; ++i) {
+            data[i] = patterns[i]->data;
+            lengths[i] = patterns[i]->size;
+        }
+        if (i == count) mp = multi_pattern_build_(data, lengths, count);
+    }
+    free(data);
+    free(lengths);
+    return mp;
+}
 
-        size_t count = 0;
-        size_t start = 0;
-        while ((start = string_find_cstr_from(s, old_cstr, start)) != lite_string_npos) {
-            if (string_erase_range(s, start, old_len)) {
-                if (!string_insert_cstr_range(s, new_cstr, start, new_len)) return false;
-                start += new_len;
-                ++count;
+/**
+ * @brief Compiles a list of C-strings into a multi-pattern matcher.
+ *
+ * @param patterns An array of C-strings.
+ * @param count The number of C-strings.
+ * @return A pointer to the new matcher, or nullptr if a pattern is nullptr or empty,
+ * or if memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p multi_pattern_free()
+ */
+LITE_ATTR_NODISCARD lite_multi_pattern *
+multi_pattern_new_cstr(const char *const *const restrict patterns, const size_t count) {
+    if (patterns == nullptr || count == 0) return nullptr;
+
+    size_t *lengths = (size_t *) malloc(count * sizeof(size_t));
+    lite_multi_pattern *mp = nullptr;
+
+    if (lengths) {
+        size_t i = 0;
+        for (; i < count && patterns[i]; ++i)
+            lengths[i] = strlen(patterns[i]);
+
+        if (i == count) mp = multi_pattern_build_(patterns, lengths, count);
+        free(lengths);
+    }
+    return mp;
+}
+
+/**
+ * @brief Frees the memory used by a multi-pattern matcher.
+ *
+ * If the input pointer is nullptr, the function does nothing.
+ *
+ * @param mp A pointer to the matcher to be freed.
+ */
+void multi_pattern_free(lite_multi_pattern *const restrict mp) {
+    if (mp) {
+        free(mp->transitions);
+        free(mp->match);
+        free(mp->dict_link);
+        free(mp->next_same);
+        free(mp->lengths);
+        free(mp);
+    }
+}
+
+/**
+ * @brief Returns the number of patterns in a multi-pattern matcher.
+ *
+ * @param mp A pointer to the matcher.
+ * @return The number of patterns, or 0 if the matcher is invalid.
+ */
+LITE_ATTR_REPRODUCIBLE size_t multi_pattern_size(const lite_multi_pattern *const restrict mp) {
+    return mp ? mp->pattern_count : 0;
+}
+
+/**
+ * @brief Advances the automaton over a text until the next state that ends a pattern.
+ *
+ * While in the start state, bytes that cannot begin any pattern are skipped without touching the DFA.
+ *
+ * @param mp A pointer to the matcher.
+ * @param text The text being searched.
+ * @param len The length of the text.
+ * @param pos A pointer to the current position in the text, updated past the last byte consumed.
+ * @param state A pointer to the current state, updated to the state after the last byte consumed.
+ * @return The first state on the output chain of the reached state, or 0 if the end of the text was reached.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_HOT LITE_ATTR_ALWAYS_INLINE static inline uint32_t
+multi_pattern_step_(const lite_multi_pattern *const restrict mp, const char *const restrict text, const size_t len,
+                    size_t *const restrict pos, uint32_t *const restrict state) {
+    const uint32_t *const transitions = mp->transitions;
+    const size_t cc = mp->class_count;
+    size_t i = *pos;
+    uint32_t st = *state;
+
+    while (i < len) {
+        if (st == 0) {
+            // Skip ahead to the next byte that can start a match
+            if (mp->first_count == 1) {
+                const char *found = (const char *) memchr(text + i, mp->single_first, len - i);
+                if (found == nullptr) break;
+                i = (size_t) (found - text);
+            } else {
+                while (i < len && !mp->first_byte[(unsigned char) text[i]]) ++i;
+                if (i == len) break;
+            }
+        }
+        st = transitions[st * cc + mp->classes[(unsigned char) text[i++]]];
+
+        const uint32_t out = mp->match[st] != UINT32_MAX ? st : mp->dict_link[st];
+        if (out) {
+            *pos = i;
+            *state = st;
+            return out;
+        }
+    }
+    *pos = len;
+    *state = st;
+    return 0;
+}
+
+/**
+ * @brief Finds the leftmost occurrence of any pattern in a string.
+ *
+ * If several patterns start at the leftmost position, the longest one is reported.
+ *
+ * @param mp A pointer to the matcher.
+ * @param s A pointer to the string to be searched.
+ * @param pattern A pointer to store the index of the matched pattern. Can be nullptr.
+ * @return The index of the first occurrence of a pattern in the string,
+ * or \p lite_string_npos if no pattern was found.
+ */
+LITE_ATTR_HOT size_t multi_pattern_find_first(const lite_multi_pattern *const restrict mp,
+                                              const lite_string *const restrict s, size_t *const restrict pattern) {
+    if (mp && s) {
+        size_t pos = 0, best = lite_string_npos, best_len = 0, best_pattern = 0;
+        uint32_t state = 0, out;
+
+        while ((out = multi_pattern_step_(mp, s->data, s->size, &pos, &state))) {
+            // No pattern ending after this point can start before the current best match
+            if (best != lite_string_npos && pos > best + mp->max_length) break;
+
+            for (; out; out = mp->dict_link[out]) {
+                const uint32_t id = mp->match[out];
+                const size_t start = pos - mp->lengths[id];
+                if (start < best || (start == best && mp->lengths[id] > best_len)) {
+                    best = start;
+                    best_len = mp->lengths[id];
+                    best_pattern = id;
+                }
+            }
+        }
+        if (best != lite_string_npos && pattern) *pattern = best_pattern;
+        return best;
+    }
+    return lite_string_npos;
+}
+
+/**
+ * @brief Finds all the occurrences of the patterns in a string.
+ *
+ * Matches are reported in the order in which they end in the string, and may overlap.
+ * At most \p max matches are stored, but all the matches are counted,
+ * so the function can be called again with a larger buffer if needed.
+ *
+ * @param mp A pointer to the matcher.
+ * @param s A pointer to the string to be searched.
+ * @param matches A pointer to the array where the matches will be stored. Can be nullptr if \p max is 0.
+ * @param max The maximum number of matches to store.
+ * @return The total number of matches, or \p lite_string_npos if the matcher or the string is invalid.
+ */
+LITE_ATTR_HOT size_t multi_pattern_find_all(const lite_multi_pattern *const restrict mp,
+                                            const lite_string *const restrict s,
+                                            lite_pattern_match *const restrict matches, const size_t max) {
+    if (mp && s && (matches || max == 0)) {
+        size_t pos = 0, total = 0;
+        uint32_t state = 0, out;
+
+        while ((out = multi_pattern_step_(mp, s->data, s->size, &pos, &state))) {
+            for (; out; out = mp->dict_link[out]) {
+                for (uint32_t id = mp->match[out]; id != UINT32_MAX; id = mp->next_same[id]) {
+                    if (total < max) {
+                        matches[total].pattern = id;
+                        matches[total].offset = pos - mp->lengths[id];
+                    }
+                    ++total;
+                }
+            }
+        }
+        return total;
+    }
+    return lite_string_npos;
+}
+
+/**
+ * @brief Counts the occurrences of each pattern in a string.
+ *
+ * @param mp A pointer to the matcher.
+ * @param s A pointer to the string to be searched.
+ * @param counts A pointer to an array of \p multi_pattern_size() elements, where the count of each pattern will be stored.
+ * @return true if the occurrences were successfully counted, false otherwise.
+ *
+ * @note Overlapping occurrences are all counted.
+ */
+LITE_ATTR_HOT bool multi_pattern_count(const lite_multi_pattern *const restrict mp,
+                                       const lite_string *const restrict s, size_t *const restrict counts) {
+    if (mp && s && counts) {
+        memset(counts, 0, mp->pattern_count * sizeof(size_t));
+
+        size_t pos = 0;
+        uint32_t state = 0, out;
+        while ((out = multi_pattern_step_(mp, s->data, s->size, &pos, &state))) {
+            for (; out; out = mp->dict_link[out]) {
+                for (uint32_t id = mp->match[out]; id != UINT32_MAX; id = mp->next_same[id])
+                    ++counts[id];
             }
         }
-        return count > 0;
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Shrinks the string to a specified size.
+ *
+ * @param s A pointer to the string to be shrunk.
+ * @param size The new size for the string.
+ * @return true if the string was successfully shrunk, false otherwise.
+ *
+ * @note Extra characters are removed from the end of the string.
+ */
+bool string_shrink(lite_string *const restrict s, const size_t size) {
+    if (s && size < s->size) {
+        s->size = size;
+        s->data[size] = '\0';
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Shrinks the string to fit its size.
+ *
+ * @param s A pointer to the string to be shrunk.
+ * @return true if the string was successfully shrunk or if shrinking was unnecessary, false otherwise.
+ */
+bool string_shrink_to_fit(lite_string *const restrict s) {
+    if (s) {
+        if (s->offset) lite_rebase_(s);
+        // If the string is empty, or if the size is equal to the capacity, no resizing is necessary
+        if (!s->size || s->size == s->capacity) return true;
+
+        char *temp = (char *) realloc(s->data, s->size * sizeof(char));
+        if (temp) {
+            s->data = temp;
+            s->capacity = s->size;
+            return true;
+        }
     }
     return false;
 }
 
 /**
- * @brief Duplicates a string.
+ * @brief Computes how many characters can be added to a string without resizing it.
+ *
+ * @param s A pointer to the string.
+ * @return The spare capacity, leaving room for the null terminator.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline size_t lite_spare_(const lite_string *const restrict s) {
+    // A string shrunk to fit has no room left, not even for the null terminator
+    return s->capacity > s->size ? s->capacity - s->size - 1 : 0;
+}
+
+/**
+ * @brief Makes room at the end of a string for characters to be written directly.
+ *
+ * The string is resized if needed, so that at least \p n more characters fit,
+ * and a pointer to the space after the last character is returned.
+ * The characters written there become part of the string when \p string_commit_append() is called,
+ * which saves formatting into a temporary buffer and copying it.
+ *
+ * @param s A pointer to the string.
+ * @param n The number of characters that will be written at most.
+ * @return A pointer to the space after the last character of the string,
+ * or nullptr if the string is invalid or memory allocation failed.
+ *
+ * @note The pointer is invalidated by any other change to the string.
+ */
+char *string_prepare_append(lite_string *const restrict s, const size_t n) {
+    if (s == nullptr || n > SIZE_MAX - 1 - s->size || !string_reserve(s, s->size + n)) return nullptr;
+    return s->data + s->size;
+}
+
+/**
+ * @brief Adds the characters written after the end of a string to it.
+ *
+ * @param s A pointer to the string.
+ * @param written The number of characters written after the end, after calling \p string_prepare_append()
+ * @return true if the characters were added, false if the string is invalid,
+ * or if there is not enough room for them.
+ */
+bool string_commit_append(lite_string *const restrict s, const size_t written) {
+    if (s == nullptr || written > lite_spare_(s)) return false;
+    s->size += written;
+    return true;
+}
+
+/**
+ * @brief Changes the size of a string, without initializing the new characters.
+ *
+ * When the string grows, the new characters are unspecified, and are meant to be overwritten by the caller
+ * through \p string_data(). When it shrinks, the extra characters are removed from the end.
+ *
+ * @param s A pointer to the string.
+ * @param size The new size of the string.
+ * @return true if the size was changed, false if the string is invalid or memory allocation failed.
+ */
+bool string_resize_uninit(lite_string *const restrict s, const size_t size) {
+    if (s == nullptr) return false;
+    if (size > s->size) {
+        if (size == SIZE_MAX || !string_reserve(s, size)) return false;
+    } else if (size < s->size) s->data[size] = '\0';
+
+    s->size = size;
+    return true;
+}
+
+/**
+ * @brief Checks if a character is a whitespace character.
+ *
+ * @param c The character to be checked.
+ * @return true if the character is a space, or lies between '\t' and '\r' inclusive, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline bool lite_is_space_(const char c) {
+    return c == ' ' || (unsigned char) (c - '\t') <= 4;
+}
+
+/**
+ * @brief Counts the whitespace characters at the start of a buffer.
+ *
+ * @param p A pointer to the buffer.
+ * @param n The size of the buffer.
+ * @return The index of the first non-whitespace character, or \p n if there is none.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static size_t lite_span_space_(const char *const restrict p, const size_t n) {
+    size_t i = 0;
+#if LITE_HAS_SSE2
+    for (; i + 16 <= n; i += 16) {
+        const unsigned mask = lite_space_mask_(_mm_loadu_si128((const __m128i *) (p + i))) ^ 0xFFFFu;
+        if (mask) return i + lite_ctz_(mask);
+    }
+#endif
+    while (i < n && lite_is_space_(p[i])) ++i;
+    return i;
+}
+
+/**
+ * @brief Counts the non-whitespace characters at the start of a buffer.
+ *
+ * @param p A pointer to the buffer.
+ * @param n The size of the buffer.
+ * @return The index of the first whitespace character, or \p n if there is none.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static size_t lite_span_non_space_(const char *const restrict p, const size_t n) {
+    size_t i = 0;
+#if LITE_HAS_SSE2
+    for (; i + 16 <= n; i += 16) {
+        const unsigned mask = lite_space_mask_(_mm_loadu_si128((const __m128i *) (p + i)));
+        if (mask) return i + lite_ctz_(mask);
+    }
+#endif
+    while (i < n && !lite_is_space_(p[i])) ++i;
+    return i;
+}
+
+/**
+ * @brief Finds the end of a buffer without its trailing whitespace characters.
+ *
+ * @param p A pointer to the buffer.
+ * @param n The size of the buffer.
+ * @return The size of the buffer without its trailing whitespace characters.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static size_t lite_trimmed_end_(const char *const restrict p, size_t n) {
+#if LITE_HAS_SSE2
+    // Skip whole blocks of whitespace, the block with the last non-whitespace character is finished below
+    while (n >= 16 && lite_space_mask_(_mm_loadu_si128((const __m128i *) (p + n - 16))) == 0xFFFFu) n -= 16;
+#endif
+    while (n && lite_is_space_(p[n - 1])) --n;
+    return n;
+}
+
+/**
+ * @brief Removes the whitespace characters from the start of a string.
+ *
+ * The characters are not moved, the start of the string is advanced instead,
+ * and the skipped space is reclaimed the next time the string has to grow.
+ *
+ * @param s A pointer to the string to be trimmed.
+ * @return true if the string was successfully trimmed, false otherwise.
+ *
+ * @note Whitespace characters are ' ', '\t', '\n', '\v', '\f' and '\r'.
+ */
+LITE_ATTR_HOT bool string_trim_left(lite_string *const restrict s) {
+    if (s) {
+        const size_t n = lite_span_space_(s->data, s->size);
+        if (n == s->size) {
+            // Nothing is left, so the whole allocation can be reused right away
+            string_clear(s);
+        } else if (n) {
+            lite_drop_front_(s, n);
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Removes the whitespace characters from the end of a string.
+ *
+ * @param s A pointer to the string to be trimmed.
+ * @return true if the string was successfully trimmed, false otherwise.
+ *
+ * @note Whitespace characters are ' ', '\t', '\n', '\v', '\f' and '\r'.
+ */
+LITE_ATTR_HOT bool string_trim_right(lite_string *const restrict s) {
+    if (s) {
+        const size_t end = lite_trimmed_end_(s->data, s->size);
+        if (end == s->size) return true;
+
+        memset(s->data + end, '\0', s->size - end);
+        s->size = end;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Removes the whitespace characters from both ends of a string.
+ *
+ * @param s A pointer to the string to be trimmed.
+ * @return true if the string was successfully trimmed, false otherwise.
+ *
+ * @note Whitespace characters are ' ', '\t', '\n', '\v', '\f' and '\r'.
+ */
+LITE_ATTR_HOT bool string_trim(lite_string *const restrict s) {
+    // Trimming the end first leaves fewer characters to scan, if the string is all whitespace
+    return string_trim_right(s) && string_trim_left(s);
+}
+
+/**
+ * @brief Replaces every run of whitespace characters in a string with a single space.
+ *
+ * @param s A pointer to the string to be modified.
+ * @return true if the string was successfully modified, false otherwise.
+ *
+ * @note Whitespace at the ends of the string is collapsed, but not removed.
+ * Use \p string_trim() to remove it.
+ */
+bool string_collapse_whitespace(lite_string *const restrict s) {
+    if (s) {
+        char *const p = s->data;
+        const size_t n = s->size;
+        size_t read = 0, write = 0;
+        while (read < n) {
+            // Move the next word into place, which is only necessary once a run has been shortened
+            const size_t word = lite_span_non_space_(p + read, n - read);
+            if (write != read) memmove(p + write, p + read, word);
+            read += word;
+            write += word;
+            if (read == n) break;
+
+            const size_t run = lite_span_space_(p + read, n - read);
+            p[write++] = ' ';
+            read += run;
+        }
+        memset(p + write, '\0', n - write);
+        s->size = write;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Removes the whitespace characters from both ends of a view.
+ *
+ * @param view The view to be trimmed.
+ * @return A view of the same characters, without the whitespace at either end.
+ *
+ * @note Whitespace characters are ' ', '\t', '\n', '\v', '\f' and '\r'.
+ */
+LITE_ATTR_REPRODUCIBLE lite_string_view string_view_trim(const lite_string_view view) {
+    if (view.data == nullptr) return view;
+
+    const size_t end = lite_trimmed_end_(view.data, view.size);
+    const size_t start = lite_span_space_(view.data, end);
+    const lite_string_view trimmed = {view.data + start, end - start};
+    return trimmed;
+}
+
+/**
+ * @brief Counts the lines, words, bytes and whitespace characters of a range of bytes.
+ *
+ * @param p A pointer to the bytes.
+ * @param n The number of bytes.
+ * @param stats A pointer to the statistics, which are increased by the counts of the range.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_HOT static void lite_count_stats_(const char *const restrict p, const size_t n,
+                                            lite_text_stats *const restrict stats) {
+    size_t i = 0;
+    bool in_word = stats->in_word;
+#if LITE_HAS_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    // Only the last byte of the previous mask matters: whether the byte before the block is whitespace
+    __m128i prev = in_word ? _mm_setzero_si128() : _mm_set1_epi8(-1);
+    while (i + 16 <= n) {
+        // Each byte lane counts up to 255 blocks before the lanes are summed
+        __m128i lines = _mm_setzero_si128(), words = _mm_setzero_si128(), spaces = _mm_setzero_si128();
+        const size_t blocks = (n - i) / 16 < 255 ? (n - i) / 16 : 255;
+        for (size_t b = 0; b < blocks; ++b, i += 16) {
+            const __m128i block = _mm_loadu_si128((const __m128i *) (p + i));
+            const __m128i ws = lite_space_bytes_(block);
+            // A word starts at each non-whitespace byte that follows a whitespace byte
+            const __m128i before = _mm_or_si128(_mm_slli_si128(ws, 1), _mm_srli_si128(prev, 15));
+            lines = _mm_sub_epi8(lines, _mm_cmpeq_epi8(block, newline));
+            words = _mm_sub_epi8(words, _mm_andnot_si128(ws, before));
+            spaces = _mm_sub_epi8(spaces, ws);
+            prev = ws;
+        }
+        stats->lines += lite_sum_lanes_sse2_(lines);
+        stats->words += lite_sum_lanes_sse2_(words);
+        stats->spaces += lite_sum_lanes_sse2_(spaces);
+    }
+    if (i) in_word = !lite_is_space_(p[i - 1]);
+#endif // LITE_HAS_SSE2
+    for (; i < n; ++i) {
+        const bool ws = lite_is_space_(p[i]);
+        stats->lines += p[i] == '\n';
+        stats->words += !ws && !in_word;
+        stats->spaces += ws;
+        in_word = !ws;
+    }
+    stats->bytes += n;
+    stats->in_word = in_word;
+}
+
+/**
+ * @brief Counts the lines, words and bytes of a string, like the wc command.
+ *
+ * The counts are added to the statistics, so a text can be counted one chunk at a time,
+ * such as the blocks read from a file: a word that is split between two chunks is counted once.
+ * The statistics should be zero-initialized before the first chunk.
+ *
+ * @param s A pointer to the string.
+ * @param stats A pointer to the statistics to be updated.
+ * @return true if the statistics were updated, false if an argument is invalid.
+ *
+ * @note A line is counted for each '\n' character,
+ * and a word for each run of characters other than ' ', '\t', '\n', '\v', '\f' and '\r'.
+ */
+LITE_ATTR_HOT bool string_count_stats(const lite_string *const restrict s, lite_text_stats *const restrict stats) {
+    if (s && stats) {
+        lite_count_stats_(s->data, s->size, stats);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Converts all the uppercase characters in a string to lowercase.
+ *
+ * @param s A pointer to the string to be converted to lowercase.
+ */
+void string_to_lower(const lite_string *const restrict s) {
+    if (s) {
+        for (size_t i = 0; i < s->size; ++i) {
+            if (s->data[i] >= 'A' && s->data[i] <= 'Z')
+                s->data[i] += 32;
+        }
+    }
+}
+
+/**
+ * @brief Converts all the lowercase characters in a string to uppercase.
+ *
+ * @param s A pointer to the string to be converted to uppercase.
+ */
+void string_to_upper(const lite_string *const restrict s) {
+    if (s) {
+        for (size_t i = 0; i < s->size; ++i) {
+            if (s->data[i] >= 'a' && s->data[i] <= 'z')
+                s->data[i] -= 32;
+        }
+    }
+}
+
+/**
+ * @brief Converts a string to title case.
+ *
+ * @param s A pointer to the string to be converted to title case.
+ */
+void string_to_title(const lite_string *const restrict s) {
+    if (s) {
+        if (s->data[0] >= 'a' && s->data[0] <= 'z')
+            s->data[0] -= 32;
+
+        // Iterate over the rest of the string
+        for (size_t i = 1; i < s->size; ++i) {
+            if (s->data[i] == ' ' && s->data[i + 1] >= 'a' && s->data[i + 1] <= 'z')
+                s->data[i + 1] -= 32;
+        }
+    }
+}
+
+/**
+ * @brief Replaces the occurrences of a byte pattern in a string with another byte sequence.
+ *
+ * All the occurrences are located first, so that the final size is known before the string is modified.
+ * The string is then rebuilt in a single pass: forward and in place if it does not grow,
+ * or backward and in place after a single reservation if it does.
+ *
+ * @param s A pointer to the string where the occurrences will be replaced.
+ * @param old_data The pattern to be replaced.
+ * @param old_len The length of the pattern, which must not be zero.
+ * @param new_data The replacement.
+ * @param new_len The length of the replacement.
+ * @param max The maximum number of occurrences to be replaced.
+ * @return The number of occurrences replaced, or \p lite_string_npos if memory allocation failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static size_t lite_replace_(lite_string *const restrict s, const char *const restrict old_data, const size_t old_len,
+                            const char *const restrict new_data, const size_t new_len, const size_t max) {
+    size_t stack_positions[64];
+    size_t *positions = stack_positions;
+    size_t positions_capacity = sizeof stack_positions / sizeof stack_positions[0];
+    size_t count = 0;
+
+    // Locate the occurrences from left to right, without overlaps
+    size_t start = 0;
+    while (count < max && start + old_len <= s->size) {
+        const size_t index = lite_find_mem_(s->data + start, s->size - start, old_data, old_len);
+        if (index == lite_string_npos) break;
+
+        if (count == positions_capacity) {
+            size_t *temp = (size_t *) malloc(positions_capacity * 2 * sizeof(size_t));
+            if (temp == nullptr) {
+                if (positions != stack_positions) free(positions);
+                return lite_string_npos;
+            }
+            memcpy(temp, positions, count * sizeof(size_t));
+            if (positions != stack_positions) free(positions);
+            positions = temp;
+            positions_capacity *= 2;
+        }
+        positions[count++] = start + index;
+        start += index + old_len;
+    }
+    if (count == 0) return 0;
+
+    if (new_len <= old_len) {
+        // The string does not grow: move the kept parts forward, starting at the first occurrence
+        size_t dst = positions[0];
+        size_t src = positions[0];
+        for (size_t i = 0; i < count; ++i) {
+            const size_t gap = positions[i] - src;
+            memmove(s->data + dst, s->data + src, gap);
+            dst += gap;
+            memcpy(s->data + dst, new_data, new_len);
+            dst += new_len;
+            src = positions[i] + old_len;
+        }
+        memmove(s->data + dst, s->data + src, s->size - src);
+        dst += s->size - src;
+
+        // Fill the vacated space with null characters
+        memset(s->data + dst, '\0', s->size - dst);
+        s->size = dst;
+    } else {
+        const size_t growth = new_len - old_len;
+        if (growth > (SIZE_MAX - s->size) / count || !string_reserve(s, s->size + count * growth)) {
+            if (positions != stack_positions) free(positions);
+            return lite_string_npos;
+        }
+        // The string grows: move the kept parts backward, starting at the end
+        size_t src_end = s->size;
+        size_t dst_end = s->size + count * growth;
+        for (size_t i = count; i > 0; --i) {
+            const size_t tail = positions[i - 1] + old_len;
+            dst_end -= src_end - tail;
+            memmove(s->data + dst_end, s->data + tail, src_end - tail);
+            dst_end -= new_len;
+            memcpy(s->data + dst_end, new_data, new_len);
+            src_end = positions[i - 1];
+        }
+        s->size += count * growth;
+    }
+
+    if (positions != stack_positions) free(positions);
+    return count;
+}
+
+/**
+ * @brief Replaces all occurrences of a substring in a string with another substring.
+ *
+ * @param s A pointer to the string where the substrings will be replaced.
+ * @param old_sub A pointer to the substring to be replaced.
+ * @param new_sub A pointer to the substring that will replace the old substring.
+ * @return true if the substrings were successfully replaced, false otherwise.
+ */
+bool string_replace(lite_string *const restrict s, const lite_string *const restrict old_sub,
+                    const lite_string *const restrict new_sub) {
+    if (s && old_sub && new_sub) {
+        if (old_sub->size == 0) return true;
+        if (old_sub->size > s->size) return false;
+
+        const size_t count = lite_replace_(s, old_sub->data, old_sub->size, new_sub->data, new_sub->size,
+                                           lite_string_npos);
+        return count != lite_string_npos && count > 0;
+    }
+    return false;
+}
+
+/**
+ * @brief Replaces up to a given number of occurrences of a substring in a string with another substring.
+ *
+ * The occurrences are replaced from left to right.
+ *
+ * @param s A pointer to the string where the substrings will be replaced.
+ * @param old_sub A pointer to the substring to be replaced.
+ * @param new_sub A pointer to the substring that will replace the old substring.
+ * @param max The maximum number of occurrences to be replaced.
+ * @return The number of occurrences replaced, or \p lite_string_npos if the replacement failed.
+ */
+size_t string_replace_n(lite_string *const restrict s, const lite_string *const restrict old_sub,
+                        const lite_string *const restrict new_sub, const size_t max) {
+    if (s && old_sub && new_sub) {
+        if (old_sub->size == 0 || max == 0) return 0;
+        return lite_replace_(s, old_sub->data, old_sub->size, new_sub->data, new_sub->size, max);
+    }
+    return lite_string_npos;
+}
+
+/**
+ * @brief Replaces all occurrences of a character in a string with another character.
+ *
+ * @param s A pointer to the string where the characters will be replaced.
+ * @param old_char The character to be replaced.
+ * @param new_char The character to replace the old character.
+ */
+void string_replace_char(const lite_string *const restrict s, const char old_char, const char new_char) {
+    if (s && old_char != new_char) {
+        for (size_t i = 0; i < s->size; ++i) {
+            if (s->data[i] == old_char)
+                s->data[i] = new_char;
+        }
+    }
+}
+
+/**
+ * @brief Replaces each character of a string found in a set with the corresponding character of another set.
+ *
+ * Works like the \p tr utility: the character at position i of \p from is replaced by the character
+ * at position i of \p to. If a character appears more than once in \p from, the last mapping wins.\n
+ * All the mappings are applied in a single pass, through a 256-byte table computed up front.
+ *
+ * @param s A pointer to the string where the characters will be replaced.
+ * @param from The characters to be replaced.
+ * @param to The replacement characters, which must have the same length as \p from.
+ * @return true if the characters were successfully replaced, false if the arguments are invalid.
+ */
+bool string_translate(const lite_string *const restrict s, const char *const restrict from,
+                      const char *const restrict to) {
+    if (s && from && to) {
+        const size_t len = strlen(from);
+        if (len != strlen(to)) return false;
+
+        unsigned char map[256];
+        for (size_t b = 0; b < 256; ++b) map[b] = (unsigned char) b;
+        for (size_t i = 0; i < len; ++i) map[(unsigned char) from[i]] = (unsigned char) to[i];
+
+        // Only the bytes that actually change need to be looked for
+        LITE_ATTR_MAYBE_UNUSED unsigned char active[256];
+        size_t active_count = 0;
+        for (size_t b = 0; b < 256; ++b) {
+            if (map[b] != b) active[active_count++] = (unsigned char) b;
+        }
+        if (active_count == 0) return true;
+
+        unsigned char *const data = (unsigned char *) s->data;
+        size_t i = 0;
+#if LITE_HAS_SSE2
+        if (active_count <= LITE_SMALL_SET) {
+            __m128i set[LITE_SMALL_SET];
+            for (size_t k = 0; k < active_count; ++k) set[k] = _mm_set1_epi8((char) active[k]);
+
+            // Skip the blocks where no character changes
+            for (; i + 16 <= s->size; i += 16) {
+                const __m128i block = _mm_loadu_si128((const __m128i *) (data + i));
+                if (lite_small_set_mask_(block, set, active_count) == 0) continue;
+
+                for (size_t j = i; j < i + 16; ++j) data[j] = map[data[j]];
+            }
+        }
+#endif // LITE_HAS_SSE2
+        for (; i < s->size; ++i) data[i] = map[data[i]];
+
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Removes all the characters found in a set from a string.
+ *
+ * The string is compacted in place, in a single pass.
+ *
+ * @param s A pointer to the string from which the characters will be removed.
+ * @param set The characters to be removed.
+ * @return true if the characters were successfully removed, false if the arguments are invalid.
+ */
+bool string_delete_chars(lite_string *const restrict s, const char *const restrict set) {
+    if (s && set) {
+        bool remove[256] = {false};
+        LITE_ATTR_MAYBE_UNUSED unsigned char members[LITE_SMALL_SET];
+        size_t member_count = 0;
+
+        for (const char *p = set; *p; ++p) {
+            const unsigned char c = (unsigned char) *p;
+            if (!remove[c]) {
+                if (member_count < LITE_SMALL_SET) members[member_count] = c;
+                ++member_count;
+                remove[c] = true;
+            }
+        }
+        if (member_count == 0) return true;
+
+        char *const data = s->data;
+        size_t dst = 0, i = 0;
+#if LITE_HAS_SSE2
+        if (member_count <= LITE_SMALL_SET) {
+            __m128i vset[LITE_SMALL_SET];
+            for (size_t k = 0; k < member_count; ++k) vset[k] = _mm_set1_epi8((char) members[k]);
+
+            for (; i + 16 <= s->size; i += 16) {
+                const __m128i block = _mm_loadu_si128((const __m128i *) (data + i));
+                if (lite_small_set_mask_(block, vset, member_count) == 0) {
+                    // Nothing to remove: move the whole block at once
+                    _mm_storeu_si128((__m128i *) (data + dst), block);
+                    dst += 16;
+                    continue;
+                }
+                for (size_t j = i; j < i + 16; ++j) {
+                    const char c = data[j];
+                    data[dst] = c;
+                    dst += !remove[(unsigned char) c];
+                }
+            }
+        }
+#endif // LITE_HAS_SSE2
+        for (; i < s->size; ++i) {
+            const char c = data[i];
+            data[dst] = c;
+            dst += !remove[(unsigned char) c];
+        }
+
+        // Fill the vacated space with null characters
+        memset(data + dst, '\0', s->size - dst);
+        s->size = dst;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Replaces all occurrences of a C-string in a string with another C-string.
+ *
+ * @param s A pointer to the string where the C-strings will be replaced.
+ * @param old_cstr The C-string to be replaced.
+ * @param new_cstr The C-string that will replace the old C-string.
+ * @return true if the C-strings were successfully replaced, false otherwise.
+ */
+bool string_replace_cstr(lite_string *const restrict s, const char *const restrict old_cstr,
+                         const char *const restrict new_cstr) {
+    if (s && old_cstr && new_cstr) {
+        const size_t old_len = strlen(old_cstr);
+        if (old_len == 0) return true;
+        if (old_len > s->size) return false;
+
+        const size_t count = lite_replace_(s, old_cstr, old_len, new_cstr, strlen(new_cstr), lite_string_npos);
+        return count != lite_string_npos && count > 0;
+    }
+    return false;
+}
+
+/**
+ * @brief Replaces up to a given number of occurrences of a C-string in a string with another C-string.
+ *
+ * The occurrences are replaced from left to right.
+ *
+ * @param s A pointer to the string where the C-strings will be replaced.
+ * @param old_cstr The C-string to be replaced.
+ * @param new_cstr The C-string that will replace the old C-string.
+ * @param max The maximum number of occurrences to be replaced.
+ * @return The number of occurrences replaced, or \p lite_string_npos if the replacement failed.
+ */
+size_t string_replace_cstr_n(lite_string *const restrict s, const char *const restrict old_cstr,
+                             const char *const restrict new_cstr, const size_t max) {
+    if (s && old_cstr && new_cstr) {
+        const size_t old_len = strlen(old_cstr);
+        if (old_len == 0 || max == 0) return 0;
+        return lite_replace_(s, old_cstr, old_len, new_cstr, strlen(new_cstr), max);
+    }
+    return lite_string_npos;
+}
+
+/**
+ * @brief Duplicates a string.
+ *
+ * @param s A pointer to the string to be duplicated.
+ * @return A pointer to the new string, or nullptr if the duplication failed.
+ *
+ * @note The returned pointer must be freed by the caller, using the \p string_free() function.
+ */
+LITE_ATTR_NODISCARD lite_string *string_duplicate(const lite_string *const restrict s) {
+    if (s) {
+        lite_string *dup = string_new();
+        if (dup) {
+            if (string_copy(s, dup)) {
+                return dup;
+            }
+            string_free(dup);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Reverses the order of characters in a string.
+ *
+ * @param s A pointer to the string to be reversed.
+ */
+void string_reverse(const lite_string *const restrict s) {
+    if (s) {
+        // Iterate over the first half of the string
+        for (size_t i = 0; i < s->size / 2; ++i) {
+            // Swap the character at the current position with the character at the symmetric position from the end
+            const char tmp = s->data[i];
+            s->data[i] = s->data[s->size - i - 1];
+            s->data[s->size - i - 1] = tmp;
+        }
+    }
+}
+
+/**
+ * @brief Converts a string to a long long integer.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The long long integer representation of the string, or 0 if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE long long string_to_ll(const lite_string *const restrict s) {
+    long long result = 0;
+    if (s) result = strtoll(string_cstr(s), nullptr, 10);
+    return result;
+}
+
+/**
+ * @brief Converts a string to an unsigned long long integer.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The unsigned long long integer representation of the string, or 0 if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE unsigned long long string_to_ull(const lite_string *const restrict s) {
+    unsigned long long result = 0;
+    if (s) result = strtoull(string_cstr(s), nullptr, 10);
+    return result;
+}
+
+/**
+ * @brief Converts a string to a long integer.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The long integer representation of the string, or 0 if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE long string_to_l(const lite_string *const restrict s) {
+    long result = 0;
+    if (s) result = strtol(string_cstr(s), nullptr, 10);
+    return result;
+}
+
+/**
+ * @brief Converts a string to an unsigned long integer.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The unsigned long integer representation of the string, or 0 if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE unsigned long string_to_ul(const lite_string *const restrict s) {
+    unsigned long result = 0;
+    if (s) result = strtoul(string_cstr(s), nullptr, 10);
+    return result;
+}
+
+/**
+ * @brief Converts a string to an integer.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The integer representation of the string, or 0 if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE int string_to_int(const lite_string *const restrict s) {
+    return (int) string_to_l(s);
+}
+
+/**
+ * @brief Converts a string to an unsigned integer.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The unsigned integer representation of the string, or 0 if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE unsigned int string_to_uint(const lite_string *const restrict s) {
+    return (unsigned int) string_to_ul(s);
+}
+
+/**
+ * @brief Converts a string to a double.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The double representation of the string, or 0.0 if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE double string_to_double(const lite_string *const restrict s) {
+    double result = 0.0;
+    if (s) result = strtod(string_cstr(s), nullptr);
+    return result;
+}
+
+/**
+ * @brief Converts a string to a float.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The float representation of the string, or 0.0f if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE float string_to_float(const lite_string *const restrict s) {
+    float result = 0.0f;
+    if (s) result = strtof(string_cstr(s), nullptr);
+    return result;
+}
+
+/**
+ * @brief Converts a string to a long double.
+ *
+ * @param s A pointer to the string to be converted.
+ * @return The long double representation of the string, or 0.0 if the string is nullptr.
+ */
+LITE_ATTR_REPRODUCIBLE long double string_to_ldouble(const lite_string *const restrict s) {
+    long double result = 0.0;
+    if (s) result = strtold(string_cstr(s), nullptr);
+    return result;
+}
+
+/**
+ * @brief Converts a long long integer to a string.
+ *
+ * @param value The long long integer to be converted.
+ * @return A pointer to the new string containing the long long integer, or nullptr if the string creation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ll(const long long value) {
+    lite_string *s = string_new();
+    if (s) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%lld", value);
+        string_append_cstr(s, buf);
+    }
+    return s;
+}
+
+/**
+ * @brief Converts an unsigned long long integer to a string.
+ *
+ * @param value The unsigned long long integer to be converted.
+ * @return A pointer to the new string containing the unsigned long long integer,
+ * or nullptr if the string creation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ull(const unsigned long long value) {
+    lite_string *s = string_new();
+    if (s) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%llu", value);
+        string_append_cstr(s, buf);
+    }
+    return s;
+}
+
+/**
+ * @brief Converts a long integer to a string.
+ *
+ * @param value The long integer to be converted.
+ * @return A pointer to the new string containing the long integer, or nullptr if the string creation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_l(const long value) {
+    lite_string *s = string_new();
+    if (s) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%ld", value);
+        string_append_cstr(s, buf);
+    }
+    return s;
+}
+
+/**
+ * @brief Converts an unsigned long integer to a string.
+ *
+ * @param value The unsigned long integer to be converted.
+ * @return A pointer to the new string containing the unsigned long integer, or nullptr if the string creation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ul(const unsigned long value) {
+    lite_string *s = string_new();
+    if (s) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%lu", value);
+        string_append_cstr(s, buf);
+    }
+    return s;
+}
+
+/**
+ * @brief Converts an integer to a string.
+ *
+ * @param value The integer to be converted.
+ * @return A pointer to the new string containing the integer.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_int(const int value) {
+    return string_from_l(value);
+}
+
+/**
+ * @brief Converts an unsigned integer to a string.
+ *
+ * @param value The unsigned integer to be converted.
+ * @return A pointer to the new string containing the unsigned integer.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_uint(const unsigned int value) {
+    return string_from_ul(value);
+}
+
+/**
+ * @brief Converts a double to a string.
+ *
+ * @param value The double to be converted.
+ * @return A pointer to the new string containing the double, or nullptr if the string creation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_double(const double value) {
+    lite_string *s = string_new();
+    if (s) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%f", value);
+        string_append_cstr(s, buf);
+    }
+    return s;
+}
+
+/**
+ * @brief Converts a float to a string.
+ *
+ * @param value The float to be converted.
+ * @return A pointer to the new string containing the float, or nullptr if the string creation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_float(const float value) {
+    lite_string *s = string_new();
+    if (s) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%f", value);
+        string_append_cstr(s, buf);
+    }
+    return s;
+}
+
+/**
+ * @brief Converts a long double to a string.
+ *
+ * @param value The long double to be converted.
+ * @return A pointer to the new string containing the long double, or nullptr if the string creation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ldouble(const long double value) {
+    lite_string *s = string_new();
+    if (s) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%Lf", value);
+        string_append_cstr(s, buf);
+    }
+    return s;
+}
+
+/// The control byte of a slot that has never been used.
+#define LITE_MAP_EMPTY ((signed char) -128)
+/// The control byte of a slot whose entry was erased.
+#define LITE_MAP_DELETED ((signed char) -2)
+/// The number of control bytes that are probed at once.
+#define LITE_MAP_GROUP 16
+
+/// An entry of a string map.
+typedef struct lite_string_map_slot_ {
+    lite_string *key; ///< The key, which is owned by the map.
+    void *value; ///< The value, which is not owned by the map.
+    size_t hash; ///< The hash of the key, so that the table can grow without hashing the keys again.
+} lite_string_map_slot_;
+
+/**
+ * @brief A hash map from strings to pointers.
+ *
+ * The map uses open addressing in the style of a Swiss table: every slot has a control byte,
+ * which is either empty, deleted, or holds 7 bits of the hash of the key in the slot.\n
+ * Lookups compare a whole group of control bytes with the hash bits at once,
+ * and only look at the keys whose bits match. The slots and the control bytes share a single allocation.
+ */
+struct lite_string_map {
+    lite_string_map_slot_ *slots; ///< The slots, followed by their control bytes in the same allocation.
+    signed char *ctrl; ///< The control bytes, one per slot.
+    size_t capacity; ///< The number of slots, which is 0 or a power of 2 that is at least \p LITE_MAP_GROUP
+    size_t size; ///< The number of entries.
+    size_t growth_left; ///< The number of empty slots that can be filled before the map must grow.
+};
+
+/**
+ * @brief Finds the control bytes of a group that are equal to a given byte.
+ *
+ * @param group A pointer to the first control byte of the group.
+ * @param c The byte to look for.
+ * @return A bitmask with a bit set for each matching control byte.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline unsigned lite_map_match_(const signed char *const restrict group,
+                                                              const signed char c) {
+#if LITE_HAS_SSE2
+    const __m128i ctrl = _mm_loadu_si128((const __m128i *) group);
+    return (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(c)));
+#else
+    unsigned mask = 0;
+    for (unsigned i = 0; i < LITE_MAP_GROUP; ++i) mask |= (unsigned) (group[i] == c) << i;
+    return mask;
+#endif
+}
+
+/**
+ * @brief Finds the control bytes of a group that are empty or deleted.
+ *
+ * @param group A pointer to the first control byte of the group.
+ * @return A bitmask with a bit set for each free slot of the group.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline unsigned lite_map_match_free_(const signed char *const restrict group) {
+#if LITE_HAS_SSE2
+    // Only the free control bytes are negative
+    return (unsigned) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) group));
+#else
+    unsigned mask = 0;
+    for (unsigned i = 0; i < LITE_MAP_GROUP; ++i) mask |= (unsigned) (group[i] < 0) << i;
+    return mask;
+#endif
+}
+
+/**
+ * @brief Finds the slot of a key in a string map.
+ *
+ * The groups are probed in a triangular sequence, which visits every group once.
+ * The search stops at the first group that has an empty slot.
+ *
+ * @param map A pointer to the map, which must have slots.
+ * @param key A pointer to the characters of the key.
+ * @param len The length of the key.
+ * @param hash The hash of the key.
+ * @return The index of the slot holding the key, or \p lite_string_npos if the key is not in the map.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_HOT static size_t lite_map_find_(const lite_string_map *const restrict map, const char *const restrict key,
+                                           const size_t len, const size_t hash) {
+    const size_t group_mask = map->capacity / LITE_MAP_GROUP - 1;
+    const signed char h2 = (signed char) (hash & 0x7F);
+    size_t group = (hash >> 7) & group_mask;
+
+    for (size_t step = 1; step <= group_mask + 1; ++step) {
+        const size_t base = group * LITE_MAP_GROUP;
+        for (unsigned match = lite_map_match_(map->ctrl + base, h2); match; match &= match - 1) {
+            const size_t index = base + lite_ctz_(match);
+            const lite_string *const candidate = map->slots[index].key;
+            if (map->slots[index].hash == hash && candidate->size == len && memcmp(candidate->data, key, len) == 0)
+                return index;
+        }
+        if (lite_map_match_(map->ctrl + base, LITE_MAP_EMPTY)) break;
+        group = (group + step) & group_mask;
+    }
+    return lite_string_npos;
+}
+
+/**
+ * @brief Finds a free slot for a new key in a string map.
+ *
+ * @param map A pointer to the map, which must have a free slot.
+ * @param hash The hash of the new key.
+ * @return The index of the first empty or deleted slot in the probe sequence of the hash.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static size_t lite_map_find_free_(const lite_string_map *const restrict map, const size_t hash) {
+    const size_t group_mask = map->capacity / LITE_MAP_GROUP - 1;
+    size_t group = (hash >> 7) & group_mask;
+
+    for (size_t step = 1;; ++step) {
+        const size_t base = group * LITE_MAP_GROUP;
+        const unsigned free_slots = lite_map_match_free_(map->ctrl + base);
+        if (free_slots) return base + lite_ctz_(free_slots);
+        group = (group + step) & group_mask;
+    }
+}
+
+/**
+ * @brief Moves the entries of a string map into a new table with a given capacity.
+ *
+ * The keys are not hashed again, since their hashes are stored in the slots.
+ *
+ * @param map A pointer to the map.
+ * @param capacity The new number of slots, a power of 2 that is at least \p LITE_MAP_GROUP
+ * @return true if the table was successfully replaced, false if memory allocation failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static bool lite_map_rehash_(lite_string_map *const restrict map, const size_t capacity) {
+    if (capacity > (SIZE_MAX - capacity) / sizeof(lite_string_map_slot_)) return false;
+
+    lite_string_map_slot_ *slots = (lite_string_map_slot_ *) malloc(
+        capacity * sizeof(lite_string_map_slot_) + capacity);
+    if (slots == nullptr) return false;
+
+    lite_string_map old = *map;
+    map->slots = slots;
+    map->ctrl = (signed char *) (slots + capacity);
+    map->capacity = capacity;
+    map->growth_left = capacity - capacity / 8 - map->size;
+    memset(map->ctrl, LITE_MAP_EMPTY, capacity);
+
+    for (size_t i = 0; i < old.capacity; ++i) {
+        if (old.ctrl[i] >= 0) {
+            const size_t hash = old.slots[i].hash;
+            const size_t index = lite_map_find_free_(map, hash);
+            map->ctrl[index] = (signed char) (hash & 0x7F);
+            map->slots[index] = old.slots[i];
+        }
+    }
+    free(old.slots);
+    return true;
+}
+
+/**
+ * @brief Makes room for one more entry in a string map.
+ *
+ * @param map A pointer to the map.
+ * @return true if there is room for one more entry, false if memory allocation failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static bool lite_map_make_room_(lite_string_map *const restrict map) {
+    if (map->growth_left) return true;
+    // If many of the used slots were erased, rebuilding the table at the same size is enough
+    if (map->capacity && map->size <= (map->capacity - map->capacity / 8) / 2)
+        return lite_map_rehash_(map, map->capacity);
+    if (map->capacity > SIZE_MAX / 2) return false;
+    return lite_map_rehash_(map, map->capacity ? map->capacity * 2 : LITE_MAP_GROUP);
+}
+
+/**
+ * @brief Inserts a key that is not in a string map yet.
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the key, which is owned by the map on success.
+ * @param hash The hash of the key.
+ * @param value The value to be associated with the key.
+ * @return true if the entry was successfully inserted, false if memory allocation failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static bool lite_map_insert_new_(lite_string_map *const restrict map, lite_string *const restrict key,
+                                 const size_t hash, void *const value) {
+    if (!lite_map_make_room_(map)) return false;
+
+    const size_t index = lite_map_find_free_(map, hash);
+    map->growth_left -= map->ctrl[index] == LITE_MAP_EMPTY;
+    map->ctrl[index] = (signed char) (hash & 0x7F);
+    map->slots[index].key = key;
+    map->slots[index].value = value;
+    map->slots[index].hash = hash;
+    ++map->size;
+    return true;
+}
+
+/**
+ * @brief Creates a new, empty string map.
+ *
+ * No memory is allocated for the entries until the first one is inserted.
+ *
+ * @return A pointer to the new map, or nullptr if memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_map_free()
+ */
+LITE_ATTR_NODISCARD lite_string_map *string_map_new(void) {
+    return (lite_string_map *) calloc(1, sizeof(lite_string_map));
+}
+
+/**
+ * @brief Removes all the entries from a string map, and frees their keys.
+ *
+ * The memory for the slots is kept, to be reused.
+ *
+ * @param map A pointer to the map.
+ * @note The values are not freed, since the map does not own them.
+ */
+void string_map_clear(lite_string_map *const restrict map) {
+    if (map && map->size) {
+        for (size_t i = 0; i < map->capacity; ++i) {
+            if (map->ctrl[i] >= 0) string_free(map->slots[i].key);
+        }
+        memset(map->ctrl, LITE_MAP_EMPTY, map->capacity);
+        map->size = 0;
+        map->growth_left = map->capacity - map->capacity / 8;
+    }
+}
+
+/**
+ * @brief Frees the memory used by a string map, including its keys.
+ *
+ * If the input pointer is nullptr, the function does nothing.
+ *
+ * @param map A pointer to the map to be freed.
+ * @note The values are not freed, since the map does not own them.
+ */
+void string_map_free(lite_string_map *const restrict map) {
+    if (map) {
+        string_map_clear(map);
+        free(map->slots);
+        free(map);
+    }
+}
+
+/**
+ * @brief Returns the number of entries in a string map.
+ *
+ * @param map A pointer to the map.
+ * @return The number of entries, or 0 if the map is invalid.
+ */
+LITE_ATTR_REPRODUCIBLE size_t string_map_size(const lite_string_map *const restrict map) {
+    return map ? map->size : 0;
+}
+
+/**
+ * @brief Makes room in a string map for a number of entries, so that inserting them does not resize it.
+ *
+ * @param map A pointer to the map.
+ * @param count The number of entries.
+ * @return true if the map has room for the entries, false if the map is invalid or memory allocation failed.
+ */
+bool string_map_reserve(lite_string_map *const restrict map, const size_t count) {
+    if (map) {
+        if (count <= map->size + map->growth_left) return true;
+        if (count > SIZE_MAX / 8) return false;
+
+        // Keep the load factor at most 7/8
+        size_t capacity = lite_clp2_(count + count / 7 + 1);
+        if (capacity < LITE_MAP_GROUP) capacity = LITE_MAP_GROUP;
+        return lite_map_rehash_(map, capacity);
+    }
+    return false;
+}
+
+/**
+ * @brief Inserts a key into a string map, taking ownership of the key.
+ *
+ * If an equal key is already in the map, its value is replaced, and the given key is freed
+ * (unless it is the very key stored in the map).
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the key. On success, it is owned by the map and must not be used by the caller anymore.
+ * @param value The value to be associated with the key.
+ * @return true if the entry was successfully inserted, false otherwise.
+ * On failure, the caller keeps the ownership of the key.
+ */
+LITE_ATTR_HOT bool string_map_insert(lite_string_map *const restrict map, lite_string *const restrict key,
+                                     void *const value) {
+    if (map && key) {
+        const size_t hash = string_hash(key);
+        if (map->capacity) {
+            const size_t index = lite_map_find_(map, key->data, key->size, hash);
+            if (index != lite_string_npos) {
+                map->slots[index].value = value;
+                if (map->slots[index].key != key) string_free(key);
+                return true;
+            }
+        }
+        return lite_map_insert_new_(map, key, hash, value);
+    }
+    return false;
+}
+
+/**
+ * @brief Inserts a copy of a key into a string map.
+ *
+ * If an equal key is already in the map, its value is replaced, and no copy is made.
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the characters of the key.
+ * @param len The length of the key.
+ * @param value The value to be associated with the key.
+ * @return true if the entry was successfully inserted, false otherwise.
+ */
+LITE_ATTR_HOT bool string_map_insert_mem(lite_string_map *const restrict map, const char *const restrict key,
+                                         const size_t len, void *const value) {
+    if (map && (key || len == 0)) {
+        const size_t hash = lite_hash_value_(lite_hash_(key, len));
+        if (map->capacity) {
+            const size_t index = lite_map_find_(map, key, len, hash);
+            if (index != lite_string_npos) {
+                map->slots[index].value = value;
+                return true;
+            }
+        }
+
+        lite_string *copy = lite_new_with_capacity_(len);
+        if (copy == nullptr) return false;
+        if (len) memcpy(copy->data, key, len);
+        copy->size = len;
+
+        if (!lite_map_insert_new_(map, copy, hash, value)) {
+            string_free(copy);
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Looks up a key, given by its characters, in a string map.
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the characters of the key.
+ * @param len The length of the key.
+ * @return The value associated with the key, or nullptr if the key is not in the map.
+ */
+LITE_ATTR_HOT void *string_map_get_mem(const lite_string_map *const restrict map, const char *const restrict key,
+                                       const size_t len) {
+    if (map && map->size && (key || len == 0)) {
+        const size_t index = lite_map_find_(map, key, len, lite_hash_value_(lite_hash_(key, len)));
+        if (index != lite_string_npos) return map->slots[index].value;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Looks up a key in a string map.
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the key.
+ * @return The value associated with the key, or nullptr if the key is not in the map.
+ */
+LITE_ATTR_HOT void *string_map_get(const lite_string_map *const restrict map, const lite_string *const restrict key) {
+    if (map && map->size && key) {
+        const size_t index = lite_map_find_(map, key->data, key->size, string_hash(key));
+        if (index != lite_string_npos) return map->slots[index].value;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Looks up a key, given by a view, in a string map.
+ *
+ * @param map A pointer to the map.
+ * @param key The view of the key.
+ * @return The value associated with the key, or nullptr if the key is not in the map.
+ */
+LITE_ATTR_HOT void *string_map_get_view(const lite_string_map *const restrict map, const lite_string_view key) {
+    return string_map_get_mem(map, key.data, key.size);
+}
+
+/**
+ * @brief Checks if a string map contains a key.
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the key.
+ * @return true if the key is in the map, false otherwise.
+ */
+LITE_ATTR_HOT bool string_map_contains(const lite_string_map *const restrict map,
+                                       const lite_string *const restrict key) {
+    return map && map->size && key &&
+           lite_map_find_(map, key->data, key->size, string_hash(key)) != lite_string_npos;
+}
+
+/**
+ * @brief Checks if a string map contains a key, given by its characters.
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the characters of the key.
+ * @param len The length of the key.
+ * @return true if the key is in the map, false otherwise.
+ */
+LITE_ATTR_HOT bool string_map_contains_mem(const lite_string_map *const restrict map, const char *const restrict key,
+                                           const size_t len) {
+    return map && map->size && (key || len == 0) &&
+           lite_map_find_(map, key, len, lite_hash_value_(lite_hash_(key, len))) != lite_string_npos;
+}
+
+/**
+ * @brief Removes the entry in a slot of a string map, and frees its key.
+ *
+ * A slot in a group that still has an empty slot can be made empty again,
+ * since no probe sequence continues past that group. Otherwise, it is marked as deleted.
+ *
+ * @param map A pointer to the map.
+ * @param index The index of the slot.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_map_erase_slot_(lite_string_map *const restrict map, const size_t index) {
+    const signed char *const group = map->ctrl + index / LITE_MAP_GROUP * LITE_MAP_GROUP;
+    string_free(map->slots[index].key);
+    if (lite_map_match_(group, LITE_MAP_EMPTY)) {
+        map->ctrl[index] = LITE_MAP_EMPTY;
+        ++map->growth_left;
+    } else {
+        map->ctrl[index] = LITE_MAP_DELETED;
+    }
+    --map->size;
+}
+
+/**
+ * @brief Removes a key from a string map, and frees the key stored in the map.
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the key.
+ * @return true if the key was removed, false if it was not in the map.
+ */
+bool string_map_erase(lite_string_map *const restrict map, const lite_string *const restrict key) {
+    if (map && map->size && key) {
+        const size_t index = lite_map_find_(map, key->data, key->size, string_hash(key));
+        if (index != lite_string_npos) {
+            lite_map_erase_slot_(map, index);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Removes a key, given by its characters, from a string map, and frees the key stored in the map.
+ *
+ * @param map A pointer to the map.
+ * @param key A pointer to the characters of the key.
+ * @param len The length of the key.
+ * @return true if the key was removed, false if it was not in the map.
+ */
+bool string_map_erase_mem(lite_string_map *const restrict map, const char *const restrict key, const size_t len) {
+    if (map && map->size && (key || len == 0)) {
+        const size_t index = lite_map_find_(map, key, len, lite_hash_value_(lite_hash_(key, len)));
+        if (index != lite_string_npos) {
+            lite_map_erase_slot_(map, index);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Iterates over the entries of a string map.
+ *
+ * The entries are visited in an unspecified order. The map must not be modified during the iteration.
+ *
+ * @param map A pointer to the map.
+ * @param cursor A pointer to the position of the iteration, which must be set to 0 to start.
+ * @param key A pointer to store the key of the next entry. Can be nullptr.
+ * The key is owned by the map and must not be modified.
+ * @param value A pointer to store the value of the next entry. Can be nullptr.
+ * @return true if an entry was found, false if there are no more entries.
+ */
+bool string_map_next(const lite_string_map *const restrict map, size_t *const restrict cursor,
+                     const lite_string **const restrict key, void **const restrict value) {
+    if (map && cursor) {
+        for (size_t i = *cursor; i < map->capacity; ++i) {
+            if (map->ctrl[i] >= 0) {
+                if (key) *key = map->slots[i].key;
+                if (value) *value = map->slots[i].value;
+                *cursor = i + 1;
+                return true;
+            }
+        }
+        *cursor = map->capacity;
+    }
+    return false;
+}
+
+/**
+ * @brief Compares two strings lexicographically.
+ *
+ * The characters are compared as unsigned bytes. If one string is a prefix of the other,
+ * the shorter string comes first.
+ *
+ * @param s1 A pointer to the first string.
+ * @param s2 A pointer to the second string.
+ * @return A negative value if the first string comes first, a positive value if the second string comes first,
+ * or 0 if the strings are equal. An invalid string comes before any valid string.
+ */
+LITE_ATTR_REPRODUCIBLE int string_cmp(const lite_string *const restrict s1, const lite_string *const restrict s2) {
+    if (s1 == nullptr || s2 == nullptr) return (s1 != nullptr) - (s2 != nullptr);
+
+    const size_t len = s1->size < s2->size ? s1->size : s2->size;
+    if (len) {
+        const int result = memcmp(s1->data, s2->data, len);
+        if (result) return result < 0 ? -1 : 1;
+    }
+    return (s1->size > s2->size) - (s1->size < s2->size);
+}
+
+/// An element of an array being sorted, with a cached chunk of its characters.
+typedef struct lite_sort_entry_ {
+    uint64_t key; ///< The 8 characters at the current depth, in big-endian order and padded with zeros.
+    lite_string *s; ///< The string.
+} lite_sort_entry_;
+
+/**
+ * @brief Reads the 8 characters of a string at a given depth as a big-endian integer.
+ *
+ * Comparing the integers orders the strings by those characters,
+ * with the strings that end within them coming first.
+ *
+ * @param s A pointer to the string, which must have at least \p depth characters.
+ * @param depth The index of the first character.
+ * @return The characters as an integer, padded with zeros.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline uint64_t lite_sort_key_(const lite_string *const restrict s, const size_t depth) {
+    const unsigned char *const p = (const unsigned char *) s->data + depth;
+    const size_t left = s->size - depth;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && __has_builtin(__builtin_bswap64)
+    if (left >= 8) return __builtin_bswap64(lite_read64_(p));
+#elif _MSC_VER && !defined(__clang__)
+    if (left >= 8) return _byteswap_uint64(lite_read64_(p));
+#endif
+    uint64_t key = 0;
+    const size_t count = left < 8 ? left : 8;
+    for (size_t i = 0; i < count; ++i) key |= (uint64_t) p[i] << (56 - 8 * i);
+    return key;
+}
+
+/**
+ * @brief Compares two strings that are known to be equal up to a given depth.
+ *
+ * @param a A pointer to the entry of the first string.
+ * @param b A pointer to the entry of the second string.
+ * @param depth The number of leading characters that the strings share. The keys must be read at this depth.
+ * @return true if the first string comes before the second one, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline bool
+lite_sort_less_(const lite_sort_entry_ *const a, const lite_sort_entry_ *const b, const size_t depth) {
+    if (a->key != b->key) return a->key < b->key;
+
+    const size_t len = a->s->size < b->s->size ? a->s->size : b->s->size;
+    if (len > depth) {
+        const int result = memcmp(a->s->data + depth, b->s->data + depth, len - depth);
+        if (result) return result < 0;
+    }
+    return a->s->size < b->s->size;
+}
+
+/**
+ * @brief Sorts a few entries that are known to be equal up to a given depth, by insertion.
+ *
+ * @param e The entries, whose keys must be read at \p depth
+ * @param n The number of entries.
+ * @param depth The number of leading characters that all the strings share.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_sort_insertion_(lite_sort_entry_ *const restrict e, const size_t n, const size_t depth) {
+    for (size_t i = 1; i < n; ++i) {
+        const lite_sort_entry_ item = e[i];
+        size_t j = i;
+        for (; j > 0 && lite_sort_less_(&item, &e[j - 1], depth); --j) e[j] = e[j - 1];
+        e[j] = item;
+    }
+}
+
+/**
+ * @brief Restores the heap property below a node of a heap of entries.
+ *
+ * @param e The entries of the heap.
+ * @param root The index of the node.
+ * @param n The number of entries in the heap.
+ * @param depth The number of leading characters that all the strings share.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_sort_sift_down_(lite_sort_entry_ *const restrict e, size_t root, const size_t n,
+                                 const size_t depth) {
+    for (size_t child; (child = 2 * root + 1) < n; root = child) {
+        if (child + 1 < n && lite_sort_less_(&e[child], &e[child + 1], depth)) ++child;
+        if (!lite_sort_less_(&e[root], &e[child], depth)) return;
+
+        const lite_sort_entry_ temp = e[root];
+        e[root] = e[child];
+        e[child] = temp;
+    }
+}
+
+/**
+ * @brief Sorts entries that are known to be equal up to a given depth, with heapsort.
+ *
+ * This bounds the running time when the pivots keep splitting the entries unevenly.
+ *
+ * @param e The entries, whose keys must be read at \p depth
+ * @param n The number of entries, which must not be zero.
+ * @param depth The number of leading characters that all the strings share.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_sort_heap_(lite_sort_entry_ *const restrict e, const size_t n, const size_t depth) {
+    for (size_t i = n / 2; i > 0; --i) lite_sort_sift_down_(e, i - 1, n, depth);
+    for (size_t end = n - 1; end > 0; --end) {
+        const lite_sort_entry_ temp = e[0];
+        e[0] = e[end];
+        e[end] = temp;
+        lite_sort_sift_down_(e, 0, end, depth);
+    }
+}
+
+/**
+ * @brief Returns the median of three keys.
+ *
+ * @param a The first key.
+ * @param b The second key.
+ * @param c The third key.
+ * @return The key that is neither the smallest nor the largest.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline uint64_t
+lite_median_(const uint64_t a, const uint64_t b, const uint64_t c) {
+    if (a < b) return b < c ? b : a < c ? c : a;
+    return a < c ? a : b < c ? c : b;
+}
+
+/**
+ * @brief Sorts entries that are known to be equal up to a given depth, with multikey quicksort.
+ *
+ * The entries are split in three around a pivot key, comparing the cached 8-character keys only.
+ * The entries with smaller and larger keys are sorted recursively at the same depth.
+ * Among the entries equal to the pivot, the strings that end within the key come first, ordered by length,
+ * and the rest are sorted 8 characters deeper, after their keys are refreshed.
+ *
+ * @param e The entries, whose keys must be read at \p depth
+ * @param n The number of entries.
+ * @param depth The number of leading characters that all the strings share.
+ * @param budget The number of uneven partitions allowed before falling back to heapsort.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_sort_entries_(lite_sort_entry_ *restrict e, size_t n, size_t depth, size_t budget) {
+    while (n > 1) {
+        if (n <= 16) {
+            lite_sort_insertion_(e, n, depth);
+            return;
+        }
+        if (budget == 0) {
+            lite_sort_heap_(e, n, depth);
+            return;
+        }
+        --budget;
+
+        // Median of 3, or the median of 3 medians for larger partitions
+        uint64_t pivot;
+        if (n >= 128) {
+            const size_t step = n / 8;
+            pivot = lite_median_(lite_median_(e[0].key, e[step].key, e[2 * step].key),
+                                 lite_median_(e[n / 2 - step].key, e[n / 2].key, e[n / 2 + step].key),
+                                 lite_median_(e[n - 1 - 2 * step].key, e[n - 1 - step].key, e[n - 1].key));
+        } else {
+            pivot = lite_median_(e[0].key, e[n / 2].key, e[n - 1].key);
+        }
+
+        // Three-way partition: [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            const lite_sort_entry_ item = e[i];
+            if (item.key < pivot) {
+                e[i++] = e[lt];
+                e[lt++] = item;
+            } else if (item.key > pivot) {
+                e[i] = e[--gt];
+                e[gt] = item;
+            } else {
+                ++i;
+            }
+        }
+        lite_sort_entries_(e, lt, depth, budget);
+        lite_sort_entries_(e + gt, n - gt, depth, budget);
+
+        // The strings that end within the key are equal apart from their lengths, so order them by length
+        lite_sort_entry_ *equal = e + lt;
+        size_t count = gt - lt;
+        size_t done = 0;
+        for (size_t left = 0; left <= 8 && done < count; ++left) {
+            for (size_t j = done; j < count; ++j) {
+                if (equal[j].s->size - depth == left) {
+                    const lite_sort_entry_ temp = equal[j];
+                    equal[j] = equal[done];
+                    equal[done++] = temp;
+                }
+            }
+        }
+
+        // Continue with the longer strings, one key deeper
+        e = equal + done;
+        n = count - done;
+        depth += 8;
+        for (size_t j = 0; j < n; ++j) e[j].key = lite_sort_key_(e[j].s, depth);
+    }
+}
+
+/**
+ * @brief Computes how many uneven partitions a sort of a number of entries may make.
+ *
+ * @param n The number of entries.
+ * @return Twice the base-2 logarithm of the number of entries, plus a small margin.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED static size_t lite_sort_budget_(size_t n) {
+    size_t log = 0;
+    while (n >>= 1) ++log;
+    return 2 * log + 8;
+}
+
+/**
+ * @brief Copies the strings of an array into entries, with their first 8 characters as keys.
+ *
+ * @param e The entries to be filled.
+ * @param arr The array of pointers to the strings.
+ * @param n The number of strings.
+ * @return true if all the strings are valid, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static bool lite_sort_fill_(lite_sort_entry_ *const restrict e, lite_string *const *const restrict arr,
+                            const size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (arr[i] == nullptr) return false;
+        e[i].s = arr[i];
+        e[i].key = lite_sort_key_(arr[i], 0);
+    }
+    return true;
+}
+
+/**
+ * @brief Sorts an array of strings in lexicographic order.
+ *
+ * The strings are sorted with a multikey quicksort on cached 8-character chunks,
+ * so most steps compare integers instead of calling a comparison function.
+ * The order is the same as the one given by \p string_cmp()
+ *
+ * @param arr The array of pointers to the strings. The pointers are reordered, the strings are not modified.
+ * @param n The number of strings.
+ * @return true if the array was sorted, false if a string is invalid or memory allocation failed.
+ * The array is not modified on failure.
+ *
+ * @note The sort is not stable: the order of equal strings is unspecified.
+ */
+bool string_sort(lite_string **const restrict arr, const size_t n) {
+    if (arr == nullptr) return n == 0;
+    if (n < 2) return n == 0 || arr[0] != nullptr;
+    if (n > SIZE_MAX / sizeof(lite_sort_entry_)) return false;
+
+    lite_sort_entry_ *e = (lite_sort_entry_ *) malloc(n * sizeof(lite_sort_entry_));
+    if (e == nullptr) return false;
+    if (!lite_sort_fill_(e, arr, n)) {
+        free(e);
+        return false;
+    }
+
+    lite_sort_entries_(e, n, 0, lite_sort_budget_(n));
+    for (size_t i = 0; i < n; ++i) arr[i] = e[i].s;
+    free(e);
+    return true;
+}
+
+/// A unit of work for \p lite_run_parallel_()
+typedef struct lite_task_ {
+    void (*run)(void *); ///< The function to be run.
+    void *arg; ///< The argument for the function.
+} lite_task_;
+
+#if LITE_HAS_THREADS
+#if _WIN32
+/**
+ * @brief Runs a task on a new thread.
+ *
+ * @param arg A pointer to the task.
+ * @return 0.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static DWORD WINAPI lite_thread_entry_(LPVOID arg) {
+    const lite_task_ *const task = (const lite_task_ *) arg;
+    task->run(task->arg);
+    return 0;
+}
+#else
+/**
+ * @brief Runs a task on a new thread.
+ *
+ * @param arg A pointer to the task.
+ * @return nullptr.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void *lite_thread_entry_(void *arg) {
+    const lite_task_ *const task = (const lite_task_ *) arg;
+    task->run(task->arg);
+    return nullptr;
+}
+#endif // _WIN32
+#endif // LITE_HAS_THREADS
+
+/**
+ * @brief Returns the number of processors available to run threads.
+ *
+ * @return The number of processors, at least 1.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static size_t lite_hardware_threads_(void) {
+#if LITE_HAS_THREADS && _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? (size_t) info.dwNumberOfProcessors : 1;
+#elif LITE_HAS_THREADS && defined(_SC_NPROCESSORS_ONLN)
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t) count : 1;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Runs tasks in parallel, and waits for all of them to finish.
+ *
+ * The first task runs on the calling thread, and each of the others on a new thread.
+ * A task whose thread cannot be created runs on the calling thread instead.
+ *
+ * @param tasks The tasks.
+ * @param count The number of tasks, at most 64.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_run_parallel_(lite_task_ *const restrict tasks, const size_t count) {
+#if LITE_HAS_THREADS
+#if _WIN32
+    HANDLE threads[64];
+#else
+    pthread_t threads[64];
+#endif // _WIN32
+    bool started[64] = {false};
+
+    for (size_t i = 1; i < count; ++i) {
+#if _WIN32
+        threads[i] = CreateThread(nullptr, 0, lite_thread_entry_, &tasks[i], 0, nullptr);
+        started[i] = threads[i] != nullptr;
+#else
+        started[i] = pthread_create(&threads[i], nullptr, lite_thread_entry_, &tasks[i]) == 0;
+#endif // _WIN32
+        if (!started[i]) tasks[i].run(tasks[i].arg);
+    }
+    if (count) tasks[0].run(tasks[0].arg);
+
+    for (size_t i = 1; i < count; ++i) {
+        if (!started[i]) continue;
+#if _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], nullptr);
+#endif // _WIN32
+    }
+#else
+    for (size_t i = 0; i < count; ++i) tasks[i].run(tasks[i].arg);
+#endif // LITE_HAS_THREADS
+}
+
+/// The largest number of threads used by the parallel algorithms.
+#define LITE_MAX_THREADS 64
+
+/// A part of a parallel sort: sorting a run of entries, or merging two adjacent runs.
+typedef struct lite_sort_job_ {
+    lite_sort_entry_ *src; ///< The entries to be sorted, or the first of the two runs to be merged.
+    lite_sort_entry_ *dest; ///< Where the merged runs are written.
+    size_t left; ///< The number of entries to be sorted, or in the first run.
+    size_t right; ///< The number of entries in the second run.
+} lite_sort_job_;
+
+/**
+ * @brief Sorts a run of entries, and refreshes their keys for merging.
+ *
+ * @param arg A pointer to the \p lite_sort_job_ describing the run.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_sort_run_(void *const arg) {
+    const lite_sort_job_ *const job = (const lite_sort_job_ *) arg;
+    lite_sort_entries_(job->src, job->left, 0, lite_sort_budget_(job->left));
+    // Sorting deeper partitions replaced their keys
+    for (size_t i = 0; i < job->left; ++i) job->src[i].key = lite_sort_key_(job->src[i].s, 0);
+}
+
+/**
+ * @brief Merges two adjacent sorted runs of entries.
+ *
+ * @param arg A pointer to the \p lite_sort_job_ describing the runs.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_sort_merge_(void *const arg) {
+    const lite_sort_job_ *const job = (const lite_sort_job_ *) arg;
+    const lite_sort_entry_ *a = job->src, *const a_end = job->src + job->left;
+    const lite_sort_entry_ *b = a_end, *const b_end = a_end + job->right;
+    lite_sort_entry_ *out = job->dest;
+
+    while (a < a_end && b < b_end) *out++ = lite_sort_less_(b, a, 0) ? *b++ : *a++;
+    while (a < a_end) *out++ = *a++;
+    while (b < b_end) *out++ = *b++;
+}
+
+/**
+ * @brief Sorts an array of strings in lexicographic order, using several threads.
+ *
+ * The array is split into one run per thread, the runs are sorted in parallel like in \p string_sort(),
+ * and then merged pairwise, with the merges of each round also running in parallel.
+ *
+ * @param arr The array of pointers to the strings. The pointers are reordered, the strings are not modified.
+ * @param n The number of strings.
+ * @param threads The number of threads to use, or 0 to use one per processor. At most 64 threads are used.
+ * @return true if the array was sorted, false if a string is invalid or memory allocation failed.
+ * The array is not modified on failure.
+ *
+ * @note Small arrays are sorted on the calling thread only.
+ * The sort is not stable: the order of equal strings is unspecified.
+ */
+bool string_sort_parallel(lite_string **const restrict arr, const size_t n, size_t threads) {
+    if (threads == 0) threads = lite_hardware_threads_();
+    if (threads > LITE_MAX_THREADS) threads = LITE_MAX_THREADS;
+    // Each thread should have enough work to pay for starting it
+    if (threads > n / 4096) threads = n / 4096;
+    if (threads < 2) return string_sort(arr, n);
+    if (n > SIZE_MAX / (2 * sizeof(lite_sort_entry_))) return false;
+
+    lite_sort_entry_ *e = (lite_sort_entry_ *) malloc(2 * n * sizeof(lite_sort_entry_));
+    if (e == nullptr) return false;
+    if (!lite_sort_fill_(e, arr, n)) {
+        free(e);
+        return false;
+    }
+
+    size_t bounds[LITE_MAX_THREADS + 1];
+    lite_sort_job_ jobs[LITE_MAX_THREADS];
+    lite_task_ tasks[LITE_MAX_THREADS];
+    for (size_t i = 0; i <= threads; ++i) bounds[i] = n / threads * i + (i < n % threads ? i : n % threads);
+    for (size_t i = 0; i < threads; ++i) {
+        jobs[i] = (lite_sort_job_) {e + bounds[i], nullptr, bounds[i + 1] - bounds[i], 0};
+        tasks[i] = (lite_task_) {lite_sort_run_, &jobs[i]};
+    }
+    lite_run_parallel_(tasks, threads);
+
+    // Merge adjacent runs, alternating between the two halves of the buffer
+    lite_sort_entry_ *src = e, *dest = e + n;
+    for (size_t runs = threads; runs > 1; runs = (runs + 1) / 2) {
+        size_t count = 0;
+        for (size_t i = 0; i < runs; i += 2) {
+            const size_t end = i + 2 < runs ? bounds[i + 2] : bounds[runs];
+            const size_t mid = i + 1 < runs ? bounds[i + 1] : end;
+            jobs[count] = (lite_sort_job_) {src + bounds[i], dest + bounds[i], mid - bounds[i], end - mid};
+            tasks[count] = (lite_task_) {lite_sort_merge_, &jobs[count]};
+            bounds[count++] = bounds[i];
+        }
+        bounds[count] = n;
+        lite_run_parallel_(tasks, count);
+
+        lite_sort_entry_ *const temp = src;
+        src = dest;
+        dest = temp;
+    }
+
+    for (size_t i = 0; i < n; ++i) arr[i] = src[i].s;
+    free(e);
+    return true;
+}
+
+/// A part of a parallel search: the occurrences of a pattern that start in one chunk of the text.
+typedef struct lite_find_job_ {
+    const char *text; ///< The first character of the chunk.
+    size_t len; ///< The number of characters to search, including the overlap with the next chunk.
+    const char *pattern; ///< The pattern to be found.
+    size_t pattern_len; ///< The length of the pattern.
+    size_t base; ///< The index of the chunk in the whole text, added to the positions.
+    size_t max; ///< The maximum number of positions to store.
+    size_t *positions; ///< The stored positions, allocated by the job.
+    size_t stored; ///< The number of stored positions.
+    size_t count; ///< The number of occurrences found.
+    bool failed; ///< Whether memory allocation failed.
+} lite_find_job_;
+
+/**
+ * @brief Finds all the occurrences of a pattern in a chunk of text.
+ *
+ * @param arg A pointer to the \p lite_find_job_ describing the chunk.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_find_run_(void *const arg) {
+    lite_find_job_ *const job = (lite_find_job_ *) arg;
+    size_t capacity = 0, pos = 0;
+
+    while (pos < job->len) {
+        const size_t index = lite_find_mem_(job->text + pos, job->len - pos, job->pattern, job->pattern_len);
+        if (index == lite_string_npos) break;
+        pos += index;
+
+        if (job->stored < job->max) {
+            if (job->stored == capacity) {
+                const size_t new_capacity = capacity ? 2 * capacity : 64;
+                size_t *const positions = new_capacity <= SIZE_MAX / sizeof(size_t)
+                                              ? (size_t *) realloc(job->positions, new_capacity * sizeof(size_t))
+                                              : nullptr;
+                if (positions == nullptr) {
+                    job->failed = true;
+                    return;
+                }
+                job->positions = positions;
+                capacity = new_capacity;
+            }
+            job->positions[job->stored++] = job->base + pos;
+        }
+        ++job->count;
+        ++pos;
+    }
+}
+
+/**
+ * @brief Finds all the occurrences of a pattern in a range of characters, using several threads.
+ *
+ * The text is split into one chunk per thread, each starting after a newline where possible,
+ * and every thread also searches the first characters of the next chunk, so that the occurrences
+ * that cross a boundary are found by the thread of the chunk where they start.
+ * The positions found by the threads are then merged in order.
+ *
+ * Overlapping occurrences are all reported. At most \p max positions are stored, but all the occurrences
+ * are counted, so the function can be called again with a larger buffer if needed.
+ *
+ * @param text The text to be searched. The characters do not have to be null-terminated.
+ * @param pattern The pattern to be found. It must not be empty.
+ * @param positions A pointer to the array where the positions will be stored, in increasing order.
+ * Can be nullptr if \p max is 0.
+ * @param max The maximum number of positions to store.
+ * @param threads The number of threads to use, or 0 to use one per processor. At most 64 threads are used.
+ * @return The total number of occurrences, or \p lite_string_npos if an argument is invalid
+ * or memory allocation failed.
+ *
+ * @note Small texts are searched on the calling thread only.
+ */
+size_t string_view_parallel_find_all(const lite_string_view text, const lite_string_view pattern,
+                                     size_t *const restrict positions, const size_t max, size_t threads) {
+    if ((text.data == nullptr && text.size) || pattern.data == nullptr || pattern.size == 0 ||
+        (positions == nullptr && max)) return lite_string_npos;
+    if (pattern.size > text.size) return 0;
+
+    if (threads == 0) threads = lite_hardware_threads_();
+    if (threads > LITE_MAX_THREADS) threads = LITE_MAX_THREADS;
+    // Each thread should have enough work to pay for starting it
+    if (threads > text.size >> 20) threads = text.size >> 20;
+    if (threads < 1) threads = 1;
+
+    size_t bounds[LITE_MAX_THREADS + 1];
+    for (size_t i = 0; i <= threads; ++i)
+        bounds[i] = text.size / threads * i + (i < text.size % threads ? i : text.size % threads);
+    // Move the boundaries past the next newline, so that a line is searched by a single thread
+    for (size_t i = 1; i < threads; ++i) {
+        const char *const newline = (const char *) memchr(text.data + bounds[i], '\n', bounds[i + 1] - bounds[i]);
+        if (newline) bounds[i] = (size_t) (newline - text.data) + 1;
+    }
+
+    lite_find_job_ jobs[LITE_MAX_THREADS];
+    lite_task_ tasks[LITE_MAX_THREADS];
+    for (size_t i = 0; i < threads; ++i) {
+        // An occurrence that starts before the end of the chunk may end up to pattern.size - 1 characters later
+        const size_t end = text.size - bounds[i + 1] < pattern.size ? text.size : bounds[i + 1] + pattern.size - 1;
+        jobs[i] = (lite_find_job_) {text.data + bounds[i], end - bounds[i], pattern.data, pattern.size, bounds[i], max,
+                                    nullptr, 0, 0, false};
+        tasks[i] = (lite_task_) {lite_find_run_, &jobs[i]};
+    }
+    lite_run_parallel_(tasks, threads);
+
+    size_t total = 0, stored = 0;
+    for (size_t i = 0; i < threads; ++i) {
+        if (jobs[i].failed) total = lite_string_npos;
+        if (total != lite_string_npos) {
+            const size_t n = jobs[i].stored < max - stored ? jobs[i].stored : max - stored;
+            if (n) memcpy(positions + stored, jobs[i].positions, n * sizeof(size_t));
+            stored += n;
+            total += jobs[i].count;
+        }
+        free(jobs[i].positions);
+    }
+    return total;
+}
+
+/**
+ * @brief Finds all the occurrences of a substring in a string, using several threads.
+ *
+ * See \p string_view_parallel_find_all() for how the work is split between the threads.
+ *
+ * @param s A pointer to the string to be searched.
+ * @param sub A pointer to the substring to be found. It must not be empty.
+ * @param positions A pointer to the array where the positions will be stored, in increasing order.
+ * Can be nullptr if \p max is 0.
+ * @param max The maximum number of positions to store.
+ * @param threads The number of threads to use, or 0 to use one per processor. At most 64 threads are used.
+ * @return The total number of occurrences, or \p lite_string_npos if an argument is invalid
+ * or memory allocation failed.
+ */
+size_t string_parallel_find_all(const lite_string *const restrict s, const lite_string *const restrict sub,
+                                size_t *const restrict positions, const size_t max, const size_t threads) {
+    if (s == nullptr || sub == nullptr) return lite_string_npos;
+    return string_view_parallel_find_all((lite_string_view) {s->data, s->size},
+                                         (lite_string_view) {sub->data, sub->size}, positions, max, threads);
+}
+
+#if !LITE_HAS_SSE2
+/**
+ * @brief Checks whether a range of bytes is valid UTF-8, one byte or one sequence at a time.
+ *
+ * @param p A pointer to the first byte.
+ * @param end A pointer past the last byte.
+ * @return true if the bytes are valid UTF-8, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static bool
+lite_utf8_valid_scalar_(const unsigned char *restrict p, const unsigned char *const restrict end) {
+    while (p < end) {
+        // Skip runs of ASCII 8 bytes at a time
+        if (end - p >= 8 && !(lite_read64_(p) & UINT64_C(0x8080808080808080))) {
+            p += 8;
+            continue;
+        }
+        const unsigned char c = *p;
+        if (c < 0x80) {
+            ++p;
+            continue;
+        }
+
+        // The allowed range of the second byte is narrower after a few lead bytes (Unicode Table 3-7)
+        size_t len;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) len = 2;
+        else if (c >= 0xE0 && c <= 0xEF) {
+            len = 3;
+            if (c == 0xE0) lo = 0xA0;
+            else if (c == 0xED) hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            len = 4;
+            if (c == 0xF0) lo = 0x90;
+            else if (c == 0xF4) hi = 0x8F;
+        } else return false;
+
+        if ((size_t) (end - p) < len || p[1] < lo || p[1] > hi) return false;
+        for (size_t i = 2; i < len; ++i)
+            if ((p[i] & 0xC0) != 0x80) return false;
+        p += len;
+    }
+    return true;
+}
+#endif // !LITE_HAS_SSE2
+
+#if LITE_HAS_SSE2
+/**
+ * @brief Finds the UTF-8 errors in a block of 16 bytes.
+ *
+ * Every byte is checked against the three bytes before it, which are taken from the end of the previous block
+ * where needed, so sequences that cross blocks are handled without branching.
+ *
+ * @param block The block to be checked.
+ * @param prev The previous block, or zeros before the first block.
+ * @return A vector with a non-zero byte at each position that breaks the UTF-8 rules.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline __m128i lite_utf8_errors_sse2_(const __m128i block, const __m128i prev) {
+    const __m128i prev1 = _mm_or_si128(_mm_slli_si128(block, 1), _mm_srli_si128(prev, 15));
+    const __m128i prev2 = _mm_or_si128(_mm_slli_si128(block, 2), _mm_srli_si128(prev, 14));
+    const __m128i prev3 = _mm_or_si128(_mm_slli_si128(block, 3), _mm_srli_si128(prev, 13));
+
+    // A byte must be a continuation byte if and only if it follows a lead byte closely enough;
+    // the saturating subtractions leave the top bit set only after 2-, 3- and 4-byte leads respectively
+    const __m128i expected = _mm_or_si128(_mm_or_si128(_mm_subs_epu8(prev1, _mm_set1_epi8(0x40)),
+                                                       _mm_subs_epu8(prev2, _mm_set1_epi8(0x60))),
+                                          _mm_subs_epu8(prev3, _mm_set1_epi8(0x70)));
+    const __m128i must_continue = _mm_cmplt_epi8(expected, _mm_setzero_si128());
+    // As signed bytes, exactly the continuation bytes 0x80-0xBF are below -64
+    const __m128i is_continuation = _mm_cmplt_epi8(block, _mm_set1_epi8(-64));
+    __m128i errors = _mm_xor_si128(must_continue, is_continuation);
+
+    // Bytes that never appear: overlong leads 0xC0-0xC1, and leads above U+10FFFF 0xF5-0xFF
+    errors = _mm_or_si128(errors, _mm_cmpeq_epi8(_mm_and_si128(block, _mm_set1_epi8((char) 0xFE)),
+                                                 _mm_set1_epi8((char) 0xC0)));
+    errors = _mm_or_si128(errors, _mm_subs_epu8(block, _mm_set1_epi8((char) 0xF4)));
+
+    // Second bytes with a narrower range: overlongs after 0xE0 and 0xF0, surrogates after 0xED,
+    // and code points above U+10FFFF after 0xF4. Non-continuation bytes are already errors above.
+    const __m128i e0 = _mm_and_si128(_mm_cmpeq_epi8(prev1, _mm_set1_epi8((char) 0xE0)),
+                                     _mm_cmplt_epi8(block, _mm_set1_epi8((char) 0xA0)));
+    const __m128i ed = _mm_and_si128(_mm_cmpeq_epi8(prev1, _mm_set1_epi8((char) 0xED)),
+                                     _mm_cmpgt_epi8(block, _mm_set1_epi8((char) 0x9F)));
+    const __m128i f0 = _mm_and_si128(_mm_cmpeq_epi8(prev1, _mm_set1_epi8((char) 0xF0)),
+                                     _mm_cmplt_epi8(block, _mm_set1_epi8((char) 0x90)));
+    const __m128i f4 = _mm_and_si128(_mm_cmpeq_epi8(prev1, _mm_set1_epi8((char) 0xF4)),
+                                     _mm_cmpgt_epi8(block, _mm_set1_epi8((char) 0x8F)));
+    return _mm_or_si128(errors, _mm_or_si128(_mm_or_si128(e0, ed), _mm_or_si128(f0, f4)));
+}
+#endif // LITE_HAS_SSE2
+
+/**
+ * @brief Checks whether a range of bytes is valid UTF-8.
+ *
+ * @param data A pointer to the bytes.
+ * @param len The number of bytes.
+ * @return true if the bytes are valid UTF-8, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static bool lite_utf8_valid_(const char *const restrict data, const size_t len) {
+    const unsigned char *const p = (const unsigned char *) data;
+#if LITE_HAS_SSE2
+    // The last 3 bytes of a block leave a sequence unfinished if they are at least 0xF0, 0xE0 and 0xC0
+    const __m128i last = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                       (char) 0xEF, (char) 0xDF, (char) 0xBF);
+    __m128i prev = _mm_setzero_si128(), incomplete = _mm_setzero_si128(), errors = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) (p + i));
+        if (!_mm_movemask_epi8(block)) {
+            // An ASCII block is only wrong if the previous block ended in the middle of a sequence
+            errors = _mm_or_si128(errors, incomplete);
+            incomplete = _mm_setzero_si128();
+        } else {
+            errors = _mm_or_si128(errors, lite_utf8_errors_sse2_(block, prev));
+            incomplete = _mm_subs_epu8(block, last);
+        }
+        prev = block;
+    }
+    if (i < len) {
+        // Pad the tail with zeros, which also catches a sequence cut short by the end of the data
+        unsigned char tail[16] = {0};
+        memcpy(tail, p + i, len - i);
+        const __m128i block = _mm_loadu_si128((const __m128i *) tail);
+        errors = _mm_or_si128(errors, lite_utf8_errors_sse2_(block, prev));
+        incomplete = _mm_setzero_si128();
+    }
+    errors = _mm_or_si128(errors, incomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(errors, _mm_setzero_si128())) == 0xFFFF;
+#else
+    return lite_utf8_valid_scalar_(p, p + len);
+#endif // LITE_HAS_SSE2
+}
+
+/**
+ * @brief Checks whether a string is valid UTF-8.
+ *
+ * The string is rejected if it contains overlong encodings, surrogates (U+D800 to U+DFFF), code points above
+ * U+10FFFF, stray continuation bytes, or sequences cut short by another lead byte or by the end of the string.
+ *
+ * @param s A pointer to the string.
+ * @return true if the string is valid UTF-8, false if it is not or if the string is invalid.
+ *
+ * @note The empty string is valid UTF-8. Embedded null characters are valid, as U+0000.
+ */
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT bool string_utf8_validate(const lite_string *const restrict s) {
+    if (s == nullptr) return false;
+    return lite_utf8_valid_(s->data, s->size);
+}
+
+/**
+ * @brief Counts the continuation bytes (0x80 to 0xBF) in a range of bytes.
+ *
+ * @param data A pointer to the bytes.
+ * @param len The number of bytes.
+ * @return The number of continuation bytes.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static size_t lite_utf8_continuations_(const char *const restrict data, const size_t len) {
+    const unsigned char *const p = (const unsigned char *) data;
+    size_t count = 0, i = 0;
+#if LITE_HAS_SSE2
+    const __m128i threshold = _mm_set1_epi8(-64);
+    while (i + 16 <= len) {
+        // Each byte lane counts up to 255 blocks before the lanes are summed
+        __m128i lanes = _mm_setzero_si128();
+        const size_t blocks = (len - i) / 16 < 255 ? (len - i) / 16 : 255;
+        for (size_t b = 0; b < blocks; ++b, i += 16) {
+            const __m128i block = _mm_loadu_si128((const __m128i *) (p + i));
+            lanes = _mm_sub_epi8(lanes, _mm_cmplt_epi8(block, threshold));
+        }
+        count += lite_sum_lanes_sse2_(lanes);
+    }
+#endif // LITE_HAS_SSE2
+    for (; i + 8 <= len; i += 8) {
+        // The top bit of each byte is set only for 10xxxxxx; the multiplication sums the bytes into the top one
+        const uint64_t v = lite_read64_(p + i);
+        const uint64_t cont = v & ~(v << 1) & UINT64_C(0x8080808080808080);
+        count += (size_t) ((cont >> 7) * UINT64_C(0x0101010101010101) >> 56);
+    }
+    for (; i < len; ++i) count += (p[i] & 0xC0) == 0x80;
+    return count;
+}
+
+/**
+ * @brief Counts the code points of a UTF-8 string.
+ *
+ * @param s A pointer to the string.
+ * @return The number of code points in the string, or 0 if the string is invalid.
+ *
+ * @note The string is not validated: every byte that is not a continuation byte (0x80 to 0xBF) counts as
+ * one code point. Use \p string_utf8_validate() first if the string may not be valid UTF-8.
+ */
+LITE_ATTR_REPRODUCIBLE size_t string_utf8_length(const lite_string *const restrict s) {
+    if (s == nullptr) return 0;
+    return s->size - lite_utf8_continuations_(s->data, s->size);
+}
+
+/**
+ * @brief Finds the byte offset of a code point in a UTF-8 string.
+ *
+ * @param s A pointer to the string.
+ * @param index The index of the code point.
+ * @return The offset of the first byte of the code point, the size of the string if the index equals the number of
+ * code points, or \p lite_string_npos if the index is past that or if the string is invalid.
+ *
+ * @note Like \p string_utf8_length(), the string is not validated and code points are counted by their first bytes.
+ */
+LITE_ATTR_REPRODUCIBLE size_t string_utf8_offset(const lite_string *const restrict s, size_t index) {
+    if (s == nullptr) return lite_string_npos;
+    const unsigned char *const p = (const unsigned char *) s->data;
+    const size_t len = s->size;
+    size_t i = 0;
+#if LITE_HAS_SSE2
+    // Skip whole blocks by the number of code points that start in them
+    const __m128i threshold = _mm_set1_epi8(-64);
+    for (; i + 16 <= len; i += 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) (p + i));
+        unsigned leads = ~(unsigned) _mm_movemask_epi8(_mm_cmplt_epi8(block, threshold)) & 0xFFFF;
+        const unsigned count = lite_popcount_(leads);
+        if (index < count) {
+            for (; index; --index) leads &= leads - 1;
+            return i + lite_ctz_(leads);
+        }
+        index -= count;
+    }
+#endif // LITE_HAS_SSE2
+    for (; i + 8 <= len; i += 8) {
+        const uint64_t v = lite_read64_(p + i);
+        const uint64_t leads = ~(v & ~(v << 1)) & UINT64_C(0x8080808080808080);
+        const size_t count = (size_t) ((leads >> 7) * UINT64_C(0x0101010101010101) >> 56);
+        if (index < count) break;
+        index -= count;
+    }
+    for (; i < len; ++i) {
+        if ((p[i] & 0xC0) == 0x80) continue;
+        if (index == 0) return i;
+        --index;
+    }
+    return index == 0 ? len : lite_string_npos;
+}
+
+/**
+ * @brief Counts the UTF-16 code units needed for valid UTF-8.
+ *
+ * Every code point takes one code unit, except those encoded with 4 bytes, which take a surrogate pair.
+ *
+ * @param data A pointer to the UTF-8 bytes, which must be valid.
+ * @param len The number of bytes.
+ * @return The number of UTF-16 code units.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static size_t lite_utf8_utf16_length_(const char *const restrict data, const size_t len) {
+    const unsigned char *const p = (const unsigned char *) data;
+    size_t continuations = 0, fours = 0, i = 0;
+#if LITE_HAS_SSE2
+    const __m128i threshold = _mm_set1_epi8(-64), four = _mm_set1_epi8((char) 0xF0);
+    while (i + 16 <= len) {
+        __m128i cont_lanes = _mm_setzero_si128(), four_lanes = _mm_setzero_si128();
+        const size_t blocks = (len - i) / 16 < 255 ? (len - i) / 16 : 255;
+        for (size_t b = 0; b < blocks; ++b, i += 16) {
+            const __m128i block = _mm_loadu_si128((const __m128i *) (p + i));
+            cont_lanes = _mm_sub_epi8(cont_lanes, _mm_cmplt_epi8(block, threshold));
+            four_lanes = _mm_sub_epi8(four_lanes, _mm_cmpeq_epi8(_mm_max_epu8(block, four), block));
+        }
+        const __m128i conts = _mm_sad_epu8(cont_lanes, _mm_setzero_si128());
+        const __m128i fours_ = _mm_sad_epu8(four_lanes, _mm_setzero_si128());
+        continuations += (size_t) _mm_cvtsi128_si32(conts) + (size_t) _mm_cvtsi128_si32(_mm_srli_si128(conts, 8));
+        fours += (size_t) _mm_cvtsi128_si32(fours_) + (size_t) _mm_cvtsi128_si32(_mm_srli_si128(fours_, 8));
+    }
+#endif // LITE_HAS_SSE2
+    for (; i < len; ++i) {
+        continuations += (p[i] & 0xC0) == 0x80;
+        fours += p[i] >= 0xF0;
+    }
+    return len - continuations + fours;
+}
+
+/**
+ * @brief Decodes one code point from valid UTF-8.
+ *
+ * @param p A pointer to the pointer to the first byte of the code point. It is advanced past the code point.
+ * @return The code point.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline uint32_t lite_utf8_decode_(const unsigned char **const restrict p) {
+    const unsigned char *const q = *p;
+    if (q[0] < 0x80) {
+        *p = q + 1;
+        return q[0];
+    }
+    if (q[0] < 0xE0) {
+        *p = q + 2;
+        return (uint32_t) (q[0] & 0x1F) << 6 | (q[1] & 0x3F);
+    }
+    if (q[0] < 0xF0) {
+        *p = q + 3;
+        return (uint32_t) (q[0] & 0x0F) << 12 | (uint32_t) (q[1] & 0x3F) << 6 | (q[2] & 0x3F);
+    }
+    *p = q + 4;
+    return (uint32_t) (q[0] & 0x07) << 18 | (uint32_t) (q[1] & 0x3F) << 12 | (uint32_t) (q[2] & 0x3F) << 6 |
+           (q[3] & 0x3F);
+}
+
+/**
+ * @brief Transcodes valid UTF-8 to UTF-16 or UTF-32.
+ *
+ * Blocks of 16 ASCII bytes, and blocks of eight 2-byte sequences, are converted with vector instructions.
+ * Other blocks are decoded one code point at a time.
+ *
+ * @param data A pointer to the UTF-8 bytes, which must be valid.
+ * @param len The number of bytes.
+ * @param out16 The UTF-16 output, with room for exactly the needed code units, or nullptr for UTF-32 output.
+ * @param out32 The UTF-32 output, with room for exactly the needed code points, if \p out16 is nullptr.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline void
+lite_utf8_transcode_(const char *const restrict data, const size_t len, char16_t *restrict out16,
+                     char32_t *restrict out32) {
+    const unsigned char *p = (const unsigned char *) data;
+    const unsigned char *const end = p + len;
+    while (p < end) {
+        const unsigned char *stop = end;
+#if LITE_HAS_SSE2
+        if (end - p >= 16) {
+            const __m128i block = _mm_loadu_si128((const __m128i *) p);
+            const __m128i zero = _mm_setzero_si128();
+            if (!_mm_movemask_epi8(block)) {
+                const __m128i lo = _mm_unpacklo_epi8(block, zero), hi = _mm_unpackhi_epi8(block, zero);
+                if (out16) {
+                    _mm_storeu_si128((__m128i *) out16, lo);
+                    _mm_storeu_si128((__m128i *) (out16 + 8), hi);
+                    out16 += 16;
+                } else {
+                    _mm_storeu_si128((__m128i *) out32, _mm_unpacklo_epi16(lo, zero));
+                    _mm_storeu_si128((__m128i *) (out32 + 4), _mm_unpackhi_epi16(lo, zero));
+                    _mm_storeu_si128((__m128i *) (out32 + 8), _mm_unpacklo_epi16(hi, zero));
+                    _mm_storeu_si128((__m128i *) (out32 + 12), _mm_unpackhi_epi16(hi, zero));
+                    out32 += 16;
+                }
+                p += 16;
+                continue;
+            }
+            // In little-endian 16-bit lanes, a 2-byte sequence reads 10xxxxxx 110xxxxx
+            const __m128i pairs = _mm_and_si128(block, _mm_set1_epi16((short) 0xC0E0));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(pairs, _mm_set1_epi16((short) 0x80C0))) == 0xFFFF) {
+                const __m128i lead = _mm_and_si128(block, _mm_set1_epi16(0x1F));
+                const __m128i cont = _mm_and_si128(_mm_srli_epi16(block, 8), _mm_set1_epi16(0x3F));
+                const __m128i units = _mm_or_si128(_mm_slli_epi16(lead, 6), cont);
+                if (out16) {
+                    _mm_storeu_si128((__m128i *) out16, units);
+                    out16 += 8;
+                } else {
+                    _mm_storeu_si128((__m128i *) out32, _mm_unpacklo_epi16(units, zero));
+                    _mm_storeu_si128((__m128i *) (out32 + 4), _mm_unpackhi_epi16(units, zero));
+                    out32 += 8;
+                }
+                p += 16;
+                continue;
+            }
+            // Decode the mixed block one code point at a time, before trying the vector paths again
+            stop = p + 16;
+        }
+#endif // LITE_HAS_SSE2
+        while (p < stop) {
+            const uint32_t c = lite_utf8_decode_(&p);
+            if (out16 == nullptr) *out32++ = c;
+            else if (c < 0x10000) *out16++ = (char16_t) c;
+            else {
+                *out16++ = (char16_t) (0xD7C0 + (c >> 10));
+                *out16++ = (char16_t) (0xDC00 | (c & 0x3FF));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Counts the UTF-8 bytes needed for UTF-16, and checks that the surrogates are paired.
+ *
+ * @param src A pointer to the UTF-16 code units.
+ * @param len The number of code units.
+ * @return The number of UTF-8 bytes, or \p lite_string_npos if the UTF-16 is invalid.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static size_t lite_utf16_utf8_length_(const char16_t *const restrict src, const size_t len) {
+    if (len > SIZE_MAX / 3) return lite_string_npos;
+    size_t total = 0, i = 0;
+    while (i < len) {
+        size_t stop = len;
+#if LITE_HAS_SSE2
+        if (i + 8 <= len) {
+            const __m128i units = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i top5 = _mm_and_si128(units, _mm_set1_epi16((short) 0xF800));
+            if (!_mm_movemask_epi8(_mm_cmpeq_epi16(top5, _mm_set1_epi16((short) 0xD800)))) {
+                // Without surrogates, each unit takes 3 bytes, less one below 0x800 and one more below 0x80
+                const __m128i below_800 = _mm_cmpeq_epi16(top5, zero);
+                const __m128i below_80 = _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16((short) 0xFF80)), zero);
+                const __m128i bytes = _mm_add_epi16(_mm_set1_epi16(3), _mm_add_epi16(below_800, below_80));
+                const __m128i sums = _mm_sad_epu8(bytes, zero);
+                total += (size_t) _mm_cvtsi128_si32(sums) + (size_t) _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+                i += 8;
+                continue;
+            }
+            stop = i + 8;
+        }
+#endif // LITE_HAS_SSE2
+        while (i < stop) {
+            const uint32_t c = src[i++];
+            if (c < 0x80) total += 1;
+            else if (c < 0x800) total += 2;
+            else if ((c & 0xF800) != 0xD800) total += 3;
+            else if (c < 0xDC00 && i < len && (src[i] & 0xFC00) == 0xDC00) {
+                total += 4;
+                ++i;
+            } else return lite_string_npos;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Counts the UTF-8 bytes needed for UTF-32, and checks that every code point is a Unicode scalar value.
+ *
+ * @param src A pointer to the code points.
+ * @param len The number of code points.
+ * @return The number of UTF-8 bytes, or \p lite_string_npos if the UTF-32 is invalid.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static size_t lite_utf32_utf8_length_(const char32_t *const restrict src, const size_t len) {
+    if (len > SIZE_MAX / 4) return lite_string_npos;
+    size_t total = 0, i = 0;
+    while (i < len) {
+        size_t stop = len;
+#if LITE_HAS_SSE2
+        if (i + 4 <= len) {
+            // Blocks of ASCII take one byte per code point
+            const __m128i points = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i high = _mm_and_si128(points, _mm_set1_epi32(~0x7F));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) == 0xFFFF) {
+                total += 4;
+                i += 4;
+                continue;
+            }
+            stop = i + 4;
+        }
+#endif // LITE_HAS_SSE2
+        for (; i < stop; ++i) {
+            const uint32_t c = src[i];
+            if (c < 0x80) total += 1;
+            else if (c < 0x800) total += 2;
+            else if (c < 0x10000) {
+                if ((c & 0xF800) == 0xD800) return lite_string_npos;
+                total += 3;
+            } else if (c <= 0x10FFFF) total += 4;
+            else return lite_string_npos;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Encodes one code point as UTF-8.
+ *
+ * @param c The code point, which must be a Unicode scalar value.
+ * @param out A pointer to the output, with room for the encoded bytes.
+ * @return A pointer past the encoded bytes.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline char *lite_utf8_encode_(const uint32_t c, char *restrict out) {
+    if (c < 0x80) {
+        *out++ = (char) c;
+    } else if (c < 0x800) {
+        *out++ = (char) (0xC0 | c >> 6);
+        *out++ = (char) (0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        *out++ = (char) (0xE0 | c >> 12);
+        *out++ = (char) (0x80 | (c >> 6 & 0x3F));
+        *out++ = (char) (0x80 | (c & 0x3F));
+    } else {
+        *out++ = (char) (0xF0 | c >> 18);
+        *out++ = (char) (0x80 | (c >> 12 & 0x3F));
+        *out++ = (char) (0x80 | (c >> 6 & 0x3F));
+        *out++ = (char) (0x80 | (c & 0x3F));
+    }
+    return out;
+}
+
+/**
+ * @brief Transcodes valid UTF-16 to UTF-8.
+ *
+ * Blocks of 8 code units that are all ASCII, or all in the 2-byte range, are converted with vector instructions.
+ * Other blocks are encoded one code point at a time.
+ *
+ * @param src A pointer to the UTF-16 code units, which must be valid.
+ * @param len The number of code units.
+ * @param out A pointer to the output, with room for exactly the needed bytes.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_utf16_to_utf8_(const char16_t *const restrict src, const size_t len, char *restrict out) {
+    size_t i = 0;
+    while (i < len) {
+        size_t stop = len;
+#if LITE_HAS_SSE2
+        if (i + 8 <= len) {
+            const __m128i units = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i below_80 = _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16((short) 0xFF80)), zero);
+            const __m128i below_800 = _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16((short) 0xF800)), zero);
+            const unsigned ascii = (unsigned) _mm_movemask_epi8(below_80);
+            if (ascii == 0xFFFF) {
+                _mm_storel_epi64((__m128i *) out, _mm_packus_epi16(units, units));
+                out += 8;
+                i += 8;
+                continue;
+            }
+            if (ascii == 0 && _mm_movemask_epi8(below_800) == 0xFFFF) {
+                // Each lane becomes 110xxxxx 10xxxxxx, in memory order
+                const __m128i lead = _mm_or_si128(_mm_srli_epi16(units, 6), _mm_set1_epi16(0xC0));
+                const __m128i cont = _mm_or_si128(_mm_and_si128(units, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+                _mm_storeu_si128((__m128i *) out, _mm_or_si128(lead, _mm_slli_epi16(cont, 8)));
+                out += 16;
+                i += 8;
+                continue;
+            }
+            stop = i + 8;
+        }
+#endif // LITE_HAS_SSE2
+        while (i < stop) {
+            uint32_t c = src[i++];
+            if ((c & 0xFC00) == 0xD800) c = 0x10000 + ((c - 0xD800) << 10) + (src[i++] - 0xDC00u);
+            out = lite_utf8_encode_(c, out);
+        }
+    }
+}
+
+/**
+ * @brief Transcodes valid UTF-32 to UTF-8.
+ *
+ * Blocks of 4 ASCII code points are narrowed with vector instructions, other blocks are encoded one at a time.
+ *
+ * @param src A pointer to the code points, which must be Unicode scalar values.
+ * @param len The number of code points.
+ * @param out A pointer to the output, with room for exactly the needed bytes.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_utf32_to_utf8_(const char32_t *const restrict src, const size_t len, char *restrict out) {
+    size_t i = 0;
+    while (i < len) {
+        size_t stop = len;
+#if LITE_HAS_SSE2
+        if (i + 4 <= len) {
+            const __m128i points = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i high = _mm_and_si128(points, _mm_set1_epi32(~0x7F));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) == 0xFFFF) {
+                const __m128i words = _mm_packs_epi32(points, points);
+                const int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+                memcpy(out, &bytes, 4);
+                out += 4;
+                i += 4;
+                continue;
+            }
+            stop = i + 4;
+        }
+#endif // LITE_HAS_SSE2
+        for (; i < stop; ++i) out = lite_utf8_encode_(src[i], out);
+    }
+}
+
+/**
+ * @brief Transcodes a UTF-8 string to UTF-16.
+ *
+ * The string is validated and the exact number of code units is computed before anything is written.
+ * Code points above U+FFFF are written as surrogate pairs, in native byte order.
+ *
+ * @param s A pointer to the string.
+ * @param buf The buffer to write the code units to. Can be nullptr if \p size is 0.
+ * @param size The number of code units that fit in the buffer.
+ * @return The number of code units of the transcoded string, or \p lite_string_npos if the string is invalid
+ * or is not valid UTF-8. Nothing is written if the buffer is too small, so the buffer can be sized with a first call.
+ *
+ * @note No null terminator is written.
+ */
+size_t string_to_utf16(const lite_string *const restrict s, char16_t *const restrict buf, const size_t size) {
+    if (s == nullptr || !lite_utf8_valid_(s->data, s->size)) return lite_string_npos;
+    const size_t units = lite_utf8_utf16_length_(s->data, s->size);
+    if (units <= size && buf) lite_utf8_transcode_(s->data, s->size, buf, nullptr);
+    return units;
+}
+
+/**
+ * @brief Transcodes a UTF-8 string to UTF-32.
+ *
+ * The string is validated and the exact number of code points is computed before anything is written.
+ *
+ * @param s A pointer to the string.
+ * @param buf The buffer to write the code points to. Can be nullptr if \p size is 0.
+ * @param size The number of code points that fit in the buffer.
+ * @return The number of code points of the transcoded string, or \p lite_string_npos if the string is invalid
+ * or is not valid UTF-8. Nothing is written if the buffer is too small, so the buffer can be sized with a first call.
+ *
+ * @note No null terminator is written.
+ */
+size_t string_to_utf32(const lite_string *const restrict s, char32_t *const restrict buf, const size_t size) {
+    if (s == nullptr || !lite_utf8_valid_(s->data, s->size)) return lite_string_npos;
+    const size_t points = s->size - lite_utf8_continuations_(s->data, s->size);
+    if (points <= size && buf) lite_utf8_transcode_(s->data, s->size, nullptr, buf);
+    return points;
+}
+
+/**
+ * @brief Appends UTF-16 text to the end of a string, as UTF-8.
+ *
+ * The exact UTF-8 size is computed first, so the string is resized at most once,
+ * and the bytes are written directly into its capacity.
+ *
+ * @param s A pointer to the string.
+ * @param src A pointer to the UTF-16 code units, in native byte order. Can be nullptr if \p len is 0.
+ * @param len The number of code units.
+ * @return true if the text was appended, false if the string is invalid, the text has an unpaired surrogate,
+ * or memory allocation failed. The string is not modified on failure.
+ */
+bool string_append_utf16(lite_string *const restrict s, const char16_t *const restrict src, const size_t len) {
+    if (s == nullptr || (src == nullptr && len)) return false;
+    const size_t total = lite_utf16_utf8_length_(src, len);
+    if (total == lite_string_npos || total > SIZE_MAX - 1 - s->size) return false;
+    if (total == 0) return true;
+    if (!string_reserve(s, s->size + total)) return false;
+
+    lite_utf16_to_utf8_(src, len, s->data + s->size);
+    s->size += total;
+    return true;
+}
+
+/**
+ * @brief Appends UTF-32 text to the end of a string, as UTF-8.
+ *
+ * The exact UTF-8 size is computed first, so the string is resized at most once,
+ * and the bytes are written directly into its capacity.
+ *
+ * @param s A pointer to the string.
+ * @param src A pointer to the code points. Can be nullptr if \p len is 0.
+ * @param len The number of code points.
+ * @return true if the text was appended, false if the string is invalid, a code point is a surrogate or
+ * above U+10FFFF, or memory allocation failed. The string is not modified on failure.
+ */
+bool string_append_utf32(lite_string *const restrict s, const char32_t *const restrict src, const size_t len) {
+    if (s == nullptr || (src == nullptr && len)) return false;
+    const size_t total = lite_utf32_utf8_length_(src, len);
+    if (total == lite_string_npos || total > SIZE_MAX - 1 - s->size) return false;
+    if (total == 0) return true;
+    if (!string_reserve(s, s->size + total)) return false;
+
+    lite_utf32_to_utf8_(src, len, s->data + s->size);
+    s->size += total;
+    return true;
+}
+
+/**
+ * @brief Creates a new string from UTF-16 text, transcoded to UTF-8.
+ *
+ * @param src A pointer to the UTF-16 code units, in native byte order. Can be nullptr if \p len is 0.
+ * @param len The number of code units.
+ * @return A pointer to the new string, or nullptr if the text has an unpaired surrogate or memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD lite_string *string_from_utf16(const char16_t *const restrict src, const size_t len) {
+    if (src == nullptr && len) return nullptr;
+    const size_t total = lite_utf16_utf8_length_(src, len);
+    if (total == lite_string_npos) return nullptr;
+
+    lite_string *s = lite_new_with_capacity_(total);
+    if (s) {
+        lite_utf16_to_utf8_(src, len, s->data);
+        s->size = total;
+    }
+    return s;
+}
+
+/**
+ * @brief Creates a new string from UTF-32 text, transcoded to UTF-8.
+ *
+ * @param src A pointer to the code points. Can be nullptr if \p len is 0.
+ * @param len The number of code points.
+ * @return A pointer to the new string, or nullptr if a code point is a surrogate or above U+10FFFF,
+ * or memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p string_free()
+ */
+LITE_ATTR_NODISCARD lite_string *string_from_utf32(const char32_t *const restrict src, const size_t len) {
+    if (src == nullptr && len) return nullptr;
+    const size_t total = lite_utf32_utf8_length_(src, len);
+    if (total == lite_string_npos) return nullptr;
+
+    lite_string *s = lite_new_with_capacity_(total);
+    if (s) {
+        lite_utf32_to_utf8_(src, len, s->data);
+        s->size = total;
+    }
+    return s;
+}
+
+/// The Base64 alphabets: the standard one (RFC 4648, section 4), and the URL-safe one (section 5).
+static const char lite_base64_chars_[2][65] = {
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+};
+
+/// The values of the ASCII characters in the Base64 alphabets, or -1 for the characters outside of them.
+static const signed char lite_base64_values_[2][128] = {
+        {
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+                52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+                -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+                -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+                41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1
+        },
+        {
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1,
+                52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+                -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+                -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+                41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1
+        }
+};
+
+#if LITE_HAS_SSE2
+/**
+ * @brief Encodes 12 bytes as 16 Base64 characters.
+ *
+ * @param p A pointer to the bytes. 16 bytes must be readable.
+ * @param url_safe Whether to use the URL-safe alphabet.
+ * @return The Base64 characters.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline __m128i
+lite_base64_encode_sse2_(const unsigned char *const restrict p, const bool url_safe) {
+    // Each 32-bit lane takes 3 bytes, as b0 | b1 << 8 | b2 << 16
+    const __m128i v = _mm_setr_epi32((int) lite_read32_(p), (int) lite_read32_(p + 3),
+                                     (int) lite_read32_(p + 6), (int) lite_read32_(p + 9));
+
+    // Split every lane into four 6-bit indices, one per byte, in output order
+    __m128i idx = _mm_and_si128(_mm_srli_epi32(v, 2), _mm_set1_epi32(0x3F));
+    idx = _mm_or_si128(idx, _mm_and_si128(_mm_slli_epi32(v, 12), _mm_set1_epi32(0x3000)));
+    idx = _mm_or_si128(idx, _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi32(0x0F00)));
+    idx = _mm_or_si128(idx, _mm_and_si128(_mm_slli_epi32(v, 10), _mm_set1_epi32(0x3C0000)));
+    idx = _mm_or_si128(idx, _mm_and_si128(_mm_srli_epi32(v, 6), _mm_set1_epi32(0x030000)));
+    idx = _mm_or_si128(idx, _mm_and_si128(_mm_slli_epi32(v, 8), _mm_set1_epi32(0x3F000000)));
+
+    // The alphabet is made of ranges, so each index is shifted by the offset of its range
+    const char *const chars = lite_base64_chars_[url_safe];
+    const __m128i above_25 = _mm_cmpgt_epi8(idx, _mm_set1_epi8(25));
+    const __m128i above_51 = _mm_cmpgt_epi8(idx, _mm_set1_epi8(51));
+    const __m128i above_61 = _mm_cmpgt_epi8(idx, _mm_set1_epi8(61));
+    const __m128i above_62 = _mm_cmpgt_epi8(idx, _mm_set1_epi8(62));
+    __m128i offset = _mm_set1_epi8('A');
+    offset = _mm_add_epi8(offset, _mm_and_si128(above_25, _mm_set1_epi8('a' - 26 - 'A')));
+    offset = _mm_add_epi8(offset, _mm_and_si128(above_51, _mm_set1_epi8('0' - 52 - ('a' - 26))));
+    offset = _mm_add_epi8(offset, _mm_and_si128(above_61, _mm_set1_epi8((char) (chars[62] - 62 - ('0' - 52)))));
+    offset = _mm_add_epi8(offset, _mm_and_si128(above_62, _mm_set1_epi8((char) (chars[63] - chars[62] - 1))));
+    return _mm_add_epi8(idx, offset);
+}
+
+/**
+ * @brief Decodes 16 Base64 characters into 12 bytes.
+ *
+ * @param src A pointer to the characters.
+ * @param out A pointer to the output, with room for 12 bytes.
+ * @param url_safe Whether to use the URL-safe alphabet.
+ * @return true if all the characters belong to the alphabet, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline bool
+lite_base64_decode_sse2_(const char *const restrict src, unsigned char *const restrict out, const bool url_safe) {
+    const char *const chars = lite_base64_chars_[url_safe];
+    const __m128i c = _mm_loadu_si128((const __m128i *) src);
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmplt_epi8(c, _mm_set1_epi8('Z' + 1)));
+    const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(c, _mm_set1_epi8('z' + 1)));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    const __m128i c62 = _mm_cmpeq_epi8(c, _mm_set1_epi8(chars[62]));
+    const __m128i c63 = _mm_cmpeq_epi8(c, _mm_set1_epi8(chars[63]));
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(c62, c63)));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) return false;
+
+    __m128i v = _mm_and_si128(upper, _mm_sub_epi8(c, _mm_set1_epi8('A')));
+    v = _mm_or_si128(v, _mm_and_si128(lower, _mm_sub_epi8(c, _mm_set1_epi8('a' - 26))));
+    v = _mm_or_si128(v, _mm_and_si128(digit, _mm_add_epi8(c, _mm_set1_epi8(52 - '0'))));
+    v = _mm_or_si128(v, _mm_and_si128(c62, _mm_set1_epi8(62)));
+    v = _mm_or_si128(v, _mm_and_si128(c63, _mm_set1_epi8(63)));
+
+    // Join the four 6-bit values of every lane into 3 bytes, in output order: b0 | b1 << 8 | b2 << 16
+    const __m128i b0 = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x3F)), 2),
+                                    _mm_and_si128(_mm_srli_epi32(v, 12), _mm_set1_epi32(0x03)));
+    const __m128i b1 = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(v, 4), _mm_set1_epi32(0xF000)),
+                                    _mm_and_si128(_mm_srli_epi32(v, 10), _mm_set1_epi32(0x0F00)));
+    const __m128i b2 = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(v, 6), _mm_set1_epi32(0xC00000)),
+                                    _mm_and_si128(_mm_srli_epi32(v, 8), _mm_set1_epi32(0x3F0000)));
+    const __m128i lanes = _mm_or_si128(b0, _mm_or_si128(b1, b2));
+
+    // Close the gaps: first within each 64-bit half, then between the halves
+    const __m128i odd = _mm_and_si128(lanes, _mm_set_epi32(0xFFFFFF, 0, 0xFFFFFF, 0));
+    const __m128i halves = _mm_or_si128(_mm_and_si128(lanes, _mm_set_epi32(0, 0xFFFFFF, 0, 0xFFFFFF)),
+                                        _mm_srli_epi64(odd, 8));
+    const __m128i packed = _mm_or_si128(_mm_and_si128(halves, _mm_set_epi32(0, 0, -1, -1)),
+                                        _mm_srli_si128(_mm_and_si128(halves, _mm_set_epi32(-1, -1, 0, 0)), 2));
+    _mm_storel_epi64((__m128i *) out, packed);
+    const int last = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+    memcpy(out + 8, &last, 4);
+    return true;
+}
+#endif // LITE_HAS_SSE2
+
+/**
+ * @brief Computes the length of the Base64 encoding of some bytes.
+ *
+ * @param len The number of bytes.
+ * @param url_safe Whether the encoding is URL-safe, and therefore not padded.
+ * @return The number of Base64 characters.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED static inline size_t lite_base64_length_(const size_t len, const bool url_safe) {
+    if (url_safe) return len / 3 * 4 + (len % 3 ? len % 3 + 1 : 0);
+    return (len / 3 + (len % 3 != 0)) * 4;
+}
+
+/**
+ * @brief Encodes bytes as Base64.
+ *
+ * @param p A pointer to the bytes.
+ * @param len The number of bytes.
+ * @param out A pointer to the output, with room for exactly the encoded characters.
+ * @param url_safe Whether to use the URL-safe alphabet, without padding.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static void lite_base64_encode_(const unsigned char *const restrict p, const size_t len, char *restrict out,
+                                const bool url_safe) {
+    const char *const chars = lite_base64_chars_[url_safe];
+    size_t i = 0;
+#if LITE_HAS_SSE2
+    for (; i + 16 <= len; i += 12, out += 16)
+        _mm_storeu_si128((__m128i *) out, lite_base64_encode_sse2_(p + i, url_safe));
+#endif // LITE_HAS_SSE2
+    for (; i + 3 <= len; i += 3, out += 4) {
+        const uint32_t v = (uint32_t) p[i] << 16 | (uint32_t) p[i + 1] << 8 | p[i + 2];
+        out[0] = chars[v >> 18];
+        out[1] = chars[v >> 12 & 0x3F];
+        out[2] = chars[v >> 6 & 0x3F];
+        out[3] = chars[v & 0x3F];
+    }
+    if (i < len) {
+        const uint32_t v = (uint32_t) p[i] << 16 | (i + 1 < len ? (uint32_t) p[i + 1] << 8 : 0);
+        *out++ = chars[v >> 18];
+        *out++ = chars[v >> 12 & 0x3F];
+        if (i + 1 < len) *out++ = chars[v >> 6 & 0x3F];
+        else if (!url_safe) *out++ = '=';
+        if (!url_safe) *out = '=';
+    }
+}
+
+/**
+ * @brief Appends the Base64 encoding of some bytes to the end of a string.
+ *
+ * The exact encoded length is computed first, so the string is resized at most once,
+ * and the characters are written directly into its capacity.
+ * Large payloads can be encoded in chunks: as long as the size of every chunk but the last one is a multiple of 3,
+ * the result is the same as encoding the whole payload at once.
+ *
+ * @param s A pointer to the string.
+ * @param data A pointer to the bytes. Must not point into the string. Can be nullptr if \p len is 0.
+ * @param len The number of bytes.
+ * @param url_safe Whether to use the URL-safe alphabet ('-' and '_' instead of '+' and '/'), without padding.
+ * Otherwise, the standard alphabet is used, and the output is padded with '=' to a multiple of 4 characters.
+ * @return true if the encoding was appended, false if the string is invalid or memory allocation failed.
+ */
+bool string_append_base64(lite_string *const restrict s, const void *const restrict data, const size_t len,
+                          const bool url_safe) {
+    if (s == nullptr || (data == nullptr && len)) return false;
+    if (len / 3 >= (SIZE_MAX - 1 - s->size) / 4 - 1) return false;
+    const size_t total = lite_base64_length_(len, url_safe);
+    if (total == 0) return true;
+    if (!string_reserve(s, s->size + total)) return false;
+
+    lite_base64_encode_((const unsigned char *) data, len, s->data + s->size, url_safe);
+    s->size += total;
+    return true;
+}
+
+/**
+ * @brief Decodes Base64 characters, without padding.
+ *
+ * @param src A pointer to the characters.
+ * @param len The number of characters, which must not be 1 more than a multiple of 4.
+ * @param out A pointer to the output, with room for exactly the decoded bytes.
+ * @param url_safe Whether to use the URL-safe alphabet.
+ * @return true if the characters were decoded, false if a character is outside the alphabet,
+ * or if the unused bits of the last character are not zero.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+static bool lite_base64_decode_(const char *const restrict src, const size_t len, unsigned char *restrict out,
+                                const bool url_safe) {
+    const signed char *const values = lite_base64_values_[url_safe];
+    const unsigned char *const p = (const unsigned char *) src;
+    size_t i = 0;
+#if LITE_HAS_SSE2
+    for (; i + 16 <= len; i += 16, out += 12)
+        if (!lite_base64_decode_sse2_(src + i, out, url_safe)) return false;
+#endif // LITE_HAS_SSE2
+    // Characters outside the table map to -1 as well, so one sign test covers a whole group
+    int32_t v[4] = {0};
+    for (; i < len; i += 4) {
+        const size_t n = len - i < 4 ? len - i : 4;
+        int32_t bad = 0;
+        for (size_t k = 0; k < n; ++k) {
+            v[k] = p[i + k] < 128 ? values[p[i + k]] : -1;
+            bad |= v[k];
+        }
+        if (bad < 0) return false;
+
+        const uint32_t bits = (uint32_t) v[0] << 18 | (uint32_t) v[1] << 12 | (uint32_t) v[2] << 6 | (uint32_t) v[3];
+        *out++ = (unsigned char) (bits >> 16);
+        if (n == 2) return (v[1] & 0x0F) == 0;
+        *out++ = (unsigned char) (bits >> 8);
+        if (n == 3) return (v[2] & 0x03) == 0;
+        *out++ = (unsigned char) bits;
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes a Base64 string, and appends the bytes to the end of another string.
+ *
+ * The decoding is strict: every character must belong to the alphabet (whitespace is not skipped),
+ * padding may only appear at the end, and the unused bits of the last character must be zero.
+ * The exact decoded length is computed first, so the destination is resized at most once.
+ *
+ * @param s A pointer to the Base64 string.
+ * @param dest A pointer to the string where the bytes will be appended. Must not be the same as \p s.
+ * @param url_safe Whether to use the URL-safe alphabet, with which the padding is optional.
+ * Otherwise, the standard alphabet is used, and the length must be a multiple of 4, padding included.
+ * @return true if the string was decoded, false if it is not valid Base64, if a string is invalid,
+ * or if memory allocation failed. The destination is not modified on failure.
+ */
+bool string_decode_base64(const lite_string *const restrict s, lite_string *const restrict dest,
+                          const bool url_safe) {
+    if (s == nullptr || dest == nullptr || s == dest) return false;
+    size_t len = s->size;
+    if (!url_safe && len % 4) return false;
+    if (len && len % 4 == 0 && s->data[len - 1] == '=') {
+        --len;
+        if (s->data[len - 1] == '=') --len;
+    }
+    if (len % 4 == 1) return false;
+
+    const size_t total = len / 4 * 3 + (len % 4 ? len % 4 - 1 : 0);
+    if (total == 0) return true;
+    if (total > SIZE_MAX - 1 - dest->size || !string_reserve(dest, dest->size + total)) return false;
+
+    unsigned char *const out = (unsigned char *) dest->data + dest->size;
+    if (!lite_base64_decode_(s->data, len, out, url_safe)) {
+        // Restore the zeros past the end of the destination
+        memset(out, '\0', total);
+        return false;
+    }
+    dest->size += total;
+    return true;
+}
+
+/// The hexadecimal digits, in lowercase and in uppercase.
+static const char lite_hex_digits_[2][17] = {"0123456789abcdef", "0123456789ABCDEF"};
+
+/// The values of the ASCII hexadecimal digits, in either case, or -1 for the other characters.
+static const signed char lite_hex_values_[128] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1,
+        -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+#if LITE_HAS_SSE2
+/**
+ * @brief Converts a vector of values from 0 to 15 to hexadecimal digits.
+ *
+ * @param nibbles The values.
+ * @param uppercase Whether to use uppercase letters.
+ * @return The hexadecimal digits.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline __m128i lite_hex_digits_sse2_(const __m128i nibbles, const bool uppercase) {
+    const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                                          _mm_set1_epi8((char) ((uppercase ? 'A' : 'a') - '0' - 10)));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+/**
+ * @brief Converts a vector of hexadecimal digits, in either case, to their values.
+ *
+ * @param c The digits.
+ * @param valid Receives a mask of the bytes that are hexadecimal digits.
+ * @return The values of the digits, and zeros for the other bytes.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline __m128i lite_hex_values_sse2_(const __m128i c, __m128i *const restrict valid) {
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    // Setting bit 5 maps 'A'-'F' to 'a'-'f', and nothing else into that range
+    const __m128i folded = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                                         _mm_cmplt_epi8(folded, _mm_set1_epi8('f' + 1)));
+    *valid = _mm_or_si128(digit, letter);
+    return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                        _mm_and_si128(letter, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+}
+#endif // LITE_HAS_SSE2
+
+/**
+ * @brief Appends the hexadecimal encoding of some bytes to the end of a string.
+ *
+ * Every byte becomes two digits, the high nibble first. The string is resized at most once,
+ * and the digits are written directly into its capacity.
+ *
+ * @param s A pointer to the string.
+ * @param data A pointer to the bytes. Must not point into the string. Can be nullptr if \p len is 0.
+ * @param len The number of bytes.
+ * @param uppercase Whether to use uppercase letters for the digits above 9.
+ * @return true if the encoding was appended, false if the string is invalid or memory allocation failed.
+ */
+bool string_append_hex(lite_string *const restrict s, const void *const restrict data, const size_t len,
+                       const bool uppercase) {
+    if (s == nullptr || (data == nullptr && len)) return false;
+    if (len == 0) return true;
+    if (len > (SIZE_MAX - 1 - s->size) / 2 || !string_reserve(s, s->size + 2 * len)) return false;
+
+    const unsigned char *const p = (const unsigned char *) data;
+    const char *const digits = lite_hex_digits_[uppercase];
+    char *out = s->data + s->size;
+    size_t i = 0;
+#if LITE_HAS_SSE2
+    // Interleave the high and low nibbles of 16 bytes into 32 digits
+    const __m128i low = _mm_set1_epi8(0x0F);
+    for (; i + 16 <= len; i += 16, out += 32) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) (p + i));
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(block, 4), low), lo = _mm_and_si128(block, low);
+        _mm_storeu_si128((__m128i *) out, lite_hex_digits_sse2_(_mm_unpacklo_epi8(hi, lo), uppercase));
+        _mm_storeu_si128((__m128i *) (out + 16), lite_hex_digits_sse2_(_mm_unpackhi_epi8(hi, lo), uppercase));
+    }
+#endif // LITE_HAS_SSE2
+    for (; i < len; ++i) {
+        *out++ = digits[p[i] >> 4];
+        *out++ = digits[p[i] & 0x0F];
+    }
+    s->size += 2 * len;
+    return true;
+}
+
+/**
+ * @brief Decodes a hexadecimal string, and appends the bytes to the end of another string.
+ *
+ * The digits can be in either case. The string must have an even length, and contain nothing but digits.
+ *
+ * @param s A pointer to the hexadecimal string.
+ * @param dest A pointer to the string where the bytes will be appended. Must not be the same as \p s.
+ * @return true if the string was decoded, false if it is not valid hexadecimal, if a string is invalid,
+ * or if memory allocation failed. The destination is not modified on failure.
+ */
+bool string_decode_hex(const lite_string *const restrict s, lite_string *const restrict dest) {
+    if (s == nullptr || dest == nullptr || s == dest || s->size % 2) return false;
+    const size_t total = s->size / 2;
+    if (total == 0) return true;
+    if (total > SIZE_MAX - 1 - dest->size || !string_reserve(dest, dest->size + total)) return false;
+
+    const unsigned char *const p = (const unsigned char *) s->data;
+    unsigned char *const out = (unsigned char *) dest->data + dest->size;
+    size_t i = 0;
+#if LITE_HAS_SSE2
+    for (; i + 32 <= s->size; i += 32) {
+        __m128i valid0, valid1;
+        const __m128i v0 = lite_hex_values_sse2_(_mm_loadu_si128((const __m128i *) (p + i)), &valid0);
+        const __m128i v1 = lite_hex_values_sse2_(_mm_loadu_si128((const __m128i *) (p + i + 16)), &valid1);
+        if (_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xFFFF) break;
+
+        // Each 16-bit lane holds a high and a low digit, in that order
+        const __m128i mask = _mm_set1_epi16(0xFF);
+        const __m128i b0 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v0, mask), 4), _mm_srli_epi16(v0, 8));
+        const __m128i b1 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v1, mask), 4), _mm_srli_epi16(v1, 8));
+        _mm_storeu_si128((__m128i *) (out + i / 2), _mm_packus_epi16(b0, b1));
+    }
+#endif // LITE_HAS_SSE2
+    for (; i < s->size; i += 2) {
+        const int hi = p[i] < 128 ? lite_hex_values_[p[i]] : -1;
+        const int lo = p[i + 1] < 128 ? lite_hex_values_[p[i + 1]] : -1;
+        if ((hi | lo) < 0) {
+            // Restore the zeros past the end of the destination
+            memset(out, '\0', total);
+            return false;
+        }
+        out[i / 2] = (unsigned char) (hi << 4 | lo);
+    }
+    dest->size += total;
+    return true;
+}
+
+/**
+ * @brief Checks whether a character is unreserved in a URL, and can be left as it is when percent-encoding.
+ *
+ * The unreserved characters are the ASCII letters and digits, and '-', '.', '_' and '~' (RFC 3986, section 2.3).
+ *
+ * @param c The character to check.
+ * @return true if the character is unreserved, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline bool lite_url_plain_(const unsigned char c) {
+    // A bitmap of the unreserved characters, in two halves of 64 characters
+    static const uint64_t plain[2] = {UINT64_C(0x03FF600000000000), UINT64_C(0x47FFFFFE87FFFFFE)};
+    return c < 128 && (plain[c >> 6] >> (c & 63) & 1);
+}
+
+#if LITE_HAS_SSE2
+/**
+ * @brief Checks which bytes of a vector are unreserved characters in a URL.
+ *
+ * @param block The vector to be checked.
+ * @return A bitmask with a bit set for each unreserved character of the vector.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline unsigned lite_url_plain_mask_(const __m128i block) {
+    const __m128i folded = _mm_or_si128(block, _mm_set1_epi8(0x20));
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(folded, _mm_set1_epi8('z' + 1)));
+    // '-', '.' and the digits are almost contiguous: only '/' sits between them
+    const __m128i number = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('-' - 1)),
+                                         _mm_cmplt_epi8(block, _mm_set1_epi8('9' + 1)));
+    const __m128i marks = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('_')),
+                                       _mm_cmpeq_epi8(block, _mm_set1_epi8('~')));
+    const __m128i slash = _mm_cmpeq_epi8(block, _mm_set1_epi8('/'));
+    return (unsigned) _mm_movemask_epi8(_mm_andnot_si128(slash, _mm_or_si128(_mm_or_si128(alpha, number), marks)));
+}
+#endif // LITE_HAS_SSE2
+
+/**
+ * @brief Percent-encodes a string for use in a URL, and appends the result to the end of another string.
+ *
+ * Every byte except the unreserved characters (ASCII letters and digits, '-', '.', '_' and '~') is written as '%'
+ * followed by two uppercase hexadecimal digits. Spans of unreserved characters are found 16 bytes at a time,
+ * and copied as they are. The encoded length is computed first, so the destination is resized at most once.
+ *
+ * @param s A pointer to the string to encode.
+ * @param dest A pointer to the string where the result will be appended. Must not be the same as \p s.
+ * @return true if the string was encoded, false if a string is invalid or memory allocation failed.
+ * The destination is not modified on failure.
+ *
+ * @note Spaces are encoded as "%20", not as '+'.
+ */
+bool string_url_encode(const lite_string *const restrict s, lite_string *const restrict dest) {
+    if (s == nullptr || dest == nullptr || s == dest) return false;
+    const unsigned char *const p = (const unsigned char *) s->data;
+    const size_t len = s->size;
+    if (len == 0) return true;
+
+    size_t escapes = 0, i = 0;
+#if LITE_HAS_SSE2
+    for (; i + 16 <= len; i += 16)
+        escapes += 16 - lite_popcount_(lite_url_plain_mask_(_mm_loadu_si128((const __m128i *) (p + i))));
+#endif // LITE_HAS_SSE2
+    for (; i < len; ++i) escapes += !lite_url_plain_(p[i]);
+    if (escapes > (SIZE_MAX - 1 - dest->size - len) / 2) return false;
+    const size_t total = len + 2 * escapes;
+    if (!string_reserve(dest, dest->size + total)) return false;
+
+    char *out = dest->data + dest->size;
+    i = 0;
+    while (i < len) {
+        size_t stop = len;
+#if LITE_HAS_SSE2
+        if (i + 16 <= len) {
+            unsigned escaped = ~lite_url_plain_mask_(_mm_loadu_si128((const __m128i *) (p + i))) & 0xFFFF;
+            size_t start = i;
+            // Copy the clean span before each escaped byte at once
+            while (escaped) {
+                const size_t pos = i + lite_ctz_(escaped);
+                memcpy(out, p + start, pos - start);
+                out += pos - start;
+                *out++ = '%';
+                *out++ = lite_hex_digits_[1][p[pos] >> 4];
+                *out++ = lite_hex_digits_[1][p[pos] & 0x0F];
+                start = pos + 1;
+                escaped &= escaped - 1;
+            }
+            memcpy(out, p + start, i + 16 - start);
+            out += i + 16 - start;
+            i += 16;
+            continue;
+        }
+#endif // LITE_HAS_SSE2
+        for (; i < stop; ++i) {
+            if (lite_url_plain_(p[i])) *out++ = (char) p[i];
+            else {
+                *out++ = '%';
+                *out++ = lite_hex_digits_[1][p[i] >> 4];
+                *out++ = lite_hex_digits_[1][p[i] & 0x0F];
+            }
+        }
+    }
+    dest->size += total;
+    return true;
+}
+
+/**
+ * @brief Decodes a percent-encoded string, and appends the result to the end of another string.
+ *
+ * Every '%' must be followed by two hexadecimal digits, in either case, which are replaced by the byte they encode.
+ * Other characters are copied as they are, with the spans between escapes copied at once.
+ * The decoded length is computed first, so the destination is resized at most once.
+ *
+ * @param s A pointer to the string to decode.
+ * @param dest A pointer to the string where the result will be appended. Must not be the same as \p s.
+ * @return true if the string was decoded, false if it has a malformed escape, if a string is invalid,
+ * or if memory allocation failed. The destination is not modified on failure.
+ *
+ * @note '+' is not decoded as a space, as it only means a space in HTML form data.
+ */
+bool string_url_decode(const lite_string *const restrict s, lite_string *const restrict dest) {
+    if (s == nullptr || dest == nullptr || s == dest) return false;
+    const size_t len = s->size;
+    const size_t escapes = lite_count_byte_(s->data, len, '%');
+    if (escapes > len / 3) return false;
+    const size_t total = len - 2 * escapes;
+    if (total == 0) return true;
+    if (total > SIZE_MAX - 1 - dest->size || !string_reserve(dest, dest->size + total)) return false;
+
+    const char *in = s->data;
+    const char *const end = in + len;
+    char *const start = dest->data + dest->size;
+    char *out = start;
+    bool valid = true;
+    while (in < end) {
+        const char *const percent = (const char *) memchr(in, '%', (size_t) (end - in));
+        const size_t span = (percent ? percent : end) - in;
+        // The size was computed as if every escape was valid, so a malformed one can leave more characters
+        // than there is room for: every write is checked against the room left
+        if (span > (size_t) (start + total - out)) {
+            valid = false;
+            break;
+        }
+        memcpy(out, in, span);
+        out += span;
+        if (percent == nullptr) break;
+
+        const unsigned char hi = (unsigned char) (end - percent > 1 ? percent[1] : 0);
+        const unsigned char lo = (unsigned char) (end - percent > 2 ? percent[2] : 0);
+        const int hi_value = hi < 128 ? lite_hex_values_[hi] : -1, lo_value = lo < 128 ? lite_hex_values_[lo] : -1;
+        if ((hi_value | lo_value) < 0 || out == start + total) {
+            valid = false;
+            break;
+        }
+        *out++ = (char) (hi_value << 4 | lo_value);
+        in = percent + 3;
+    }
+    if (!valid) {
+        // Restore the zeros past the end of the destination
+        memset(start, '\0', (size_t) (out - start));
+        return false;
+    }
+    dest->size += total;
+    return true;
+}
+
+/// The short escapes of the control characters in JSON strings, or 0 for those written as "\u00XX".
+static const char lite_json_short_escapes_[32] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 'b', 't', 'n', 0, 'f', 'r', 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/**
+ * @brief Checks whether a character is special in a JSON string: a quote, a backslash, or a control character.
+ *
+ * @param c The character to check.
+ * @return true if the character is special, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_UNSEQUENCED LITE_ATTR_ALWAYS_INLINE static inline bool lite_json_special_(const unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+/**
+ * @brief Finds the first special character of a JSON string in a range of bytes.
+ *
+ * @param p A pointer to the first byte.
+ * @param end A pointer past the last byte.
+ * @return A pointer to the first quote, backslash or control character, or \p end if there is none.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static const unsigned char *
+lite_json_skip_clean_(const unsigned char *restrict p, const unsigned char *const restrict end) {
+#if LITE_HAS_SSE2
+    const __m128i limit = _mm_set1_epi8(0x1F), quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\');
+    for (; end - p >= 16; p += 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) p);
+        // max(c, 0x1F) == 0x1F only for the control characters
+        const __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(block, limit), limit);
+        const __m128i special = _mm_or_si128(control, _mm_or_si128(_mm_cmpeq_epi8(block, quote),
+                                                                   _mm_cmpeq_epi8(block, backslash)));
+        const unsigned mask = (unsigned) _mm_movemask_epi8(special);
+        if (mask) return p + lite_ctz_(mask);
+    }
+#endif // LITE_HAS_SSE2
+    while (p < end && !lite_json_special_(*p)) ++p;
+    return p;
+}
+
+/**
+ * @brief Appends a string to the end of another string, escaped for use inside a JSON string.
+ *
+ * Quotes and backslashes are preceded by a backslash, and control characters are written as "\b", "\t", "\n",
+ * "\f", "\r", or "\u00XX" otherwise. Other bytes, including non-ASCII UTF-8 sequences, are copied as they are.
+ * The runs of clean characters are found 16 bytes at a time and copied at once.
+ * The escaped length is computed first, so the destination is resized at most once.
+ *
+ * @param s A pointer to the string where the escaped string will be appended.
+ * @param src A pointer to the string to escape. Must not be the same as \p s.
+ * @return true if the escaped string was appended, false if a string is invalid or memory allocation failed.
+ *
+ * @note The surrounding quotes are not added.
+ */
+bool string_append_json_escaped(lite_string *const restrict s, const lite_string *const restrict src) {
+    if (s == nullptr || src == nullptr || s == src) return false;
+    const unsigned char *const begin = (const unsigned char *) src->data, *const end = begin + src->size;
+
+    // Every special character takes one more byte, or five more for the "\u00XX" form
+    size_t extra = 0;
+    for (const unsigned char *p = lite_json_skip_clean_(begin, end); p < end; p = lite_json_skip_clean_(p + 1, end))
+        extra += *p >= 0x20 || lite_json_short_escapes_[*p] ? 1 : 5;
+    if (src->size == 0) return true;
+    if (extra > SIZE_MAX - 1 - s->size - src->size) return false;
+    const size_t total = src->size + extra;
+    if (!string_reserve(s, s->size + total)) return false;
+
+    char *out = s->data + s->size;
+    const unsigned char *p = begin;
+    while (true) {
+        const unsigned char *const special = lite_json_skip_clean_(p, end);
+        memcpy(out, p, (size_t) (special - p));
+        out += special - p;
+        if (special == end) break;
+
+        const unsigned char c = *special;
+        *out++ = '\\';
+        if (c >= 0x20) *out++ = (char) c;
+        else if (lite_json_short_escapes_[c]) *out++ = lite_json_short_escapes_[c];
+        else {
+            memcpy(out, "u00", 3);
+            out[3] = lite_hex_digits_[0][c >> 4];
+            out[4] = lite_hex_digits_[0][c & 0x0F];
+            out += 5;
+        }
+        p = special + 1;
+    }
+    s->size += total;
+    return true;
+}
+
+/**
+ * @brief Parses the 4 hexadecimal digits of a "\uXXXX" escape.
+ *
+ * @param p A pointer to the digits.
+ * @return The value of the digits, or -1 if they are not all hexadecimal digits.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_REPRODUCIBLE static inline int32_t lite_json_hex4_(const unsigned char *const restrict p) {
+    int32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        const int digit = p[i] < 128 ? lite_hex_values_[p[i]] : -1;
+        if (digit < 0) return -1;
+        value = value << 4 | digit;
+    }
+    return value;
+}
+
+/**
+ * @brief Unescapes the contents of a JSON string, and appends the result to the end of another string.
+ *
+ * The escapes are replaced by the characters they stand for, and "\uXXXX" escapes are written as UTF-8,
+ * with surrogate pairs joined into one code point. The runs of characters between escapes are copied at once.
+ *
+ * @param s A pointer to the contents of the JSON string, without the surrounding quotes.
+ * @param dest A pointer to the string where the result will be appended. Must not be the same as \p s.
+ * @return true if the string was unescaped, false if it has an invalid escape, an unpaired surrogate,
+ * an unescaped quote or control character, if a string is invalid, or if memory allocation failed.
+ * The destination is not modified on failure.
+ */
+bool string_json_unescape(const lite_string *const restrict s, lite_string *const restrict dest) {
+    if (s == nullptr || dest == nullptr || s == dest) return false;
+    if (s->size == 0) return true;
+    // Escapes only shrink, so the input size is enough
+    if (s->size > SIZE_MAX - 1 - dest->size || !string_reserve(dest, dest->size + s->size)) return false;
+
+    const unsigned char *p = (const unsigned char *) s->data;
+    const unsigned char *const end = p + s->size;
+    char *const start = dest->data + dest->size;
+    char *out = start;
+    bool valid = true;
+    while (valid) {
+        const unsigned char *const special = lite_json_skip_clean_(p, end);
+        memcpy(out, p, (size_t) (special - p));
+        out += special - p;
+        p = special;
+        if (p == end) break;
+        if (*p != '\\' || end - p < 2) {
+            valid = false;
+            break;
+        }
+
+        const unsigned char c = p[1];
+        p += 2;
+        if (c == '"' || c == '\\' || c == '/') *out++ = (char) c;
+        else if (c == 'b') *out++ = '\b';
+        else if (c == 't') *out++ = '\t';
+        else if (c == 'n') *out++ = '\n';
+        else if (c == 'f') *out++ = '\f';
+        else if (c == 'r') *out++ = '\r';
+        else if (c == 'u') {
+            int32_t code = end - p >= 4 ? lite_json_hex4_(p) : -1;
+            size_t length = 4;
+            if (code >= 0xD800 && code <= 0xDBFF) {
+                // A high surrogate must be followed by an escaped low surrogate
+                const int32_t low = end - p >= 10 && p[4] == '\\' && p[5] == 'u' ? lite_json_hex4_(p + 6) : -1;
+                code = low >= 0xDC00 && low <= 0xDFFF ? 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00) : -1;
+                length = 10;
+            } else if (code >= 0xDC00 && code <= 0xDFFF) code = -1;
+            valid = code >= 0;
+            if (valid) {
+                out = lite_utf8_encode_((uint32_t) code, out);
+                p += length;
+            }
+        } else valid = false;
+    }
+
+    if (!valid) {
+        // Restore the zeros past the end of the destination
+        memset(start, '\0', (size_t) (out - start));
+        return false;
+    }
+    dest->size += (size_t) (out - start);
+    return true;
+}
+
+
+/// Flags a separator of a CSV parser that is a line feed.
+#define LITE_CSV_LINE ((size_t) 1)
+
+/// Flags a separator of a CSV parser that ends a field with a quote in it.
+#define LITE_CSV_QUOTED ((size_t) 2)
+
+/**
+ * @brief A streaming parser of CSV records.
+ *
+ * The input is appended to a buffer, which is indexed in two stages, in the style of simdcsv:
+ * the first stage finds the quotes, delimiters and line feeds of 64 bytes at a time,
+ * and computes which bytes are quoted with a prefix XOR of the quotes.
+ * The positions of the delimiters and line feeds outside of quotes are recorded.\n
+ * The second stage cuts the records into fields at those positions.
+ * Only the fields with quotes are checked, and unescaped in the buffer itself,
+ * so the fields are always views into the buffer.
+ */
+struct lite_csv_parser {
+    lite_string *buffer; ///< The input that has not been consumed yet.
+    size_t *ends; ///< The delimiters and line feeds outside of quotes, as their positions shifted left by 2 and flags.
+    size_t end_count; ///< The number of recorded positions.
+    size_t end_capacity; ///< The capacity of the array of positions.
+    size_t next_end; ///< The index of the first position after the last consumed record.
+    size_t record_start; ///< The position of the first character of the next record.
+    size_t scanned; ///< The number of characters of the buffer indexed so far.
+    uint64_t quoted; ///< All bits set if the end of the indexed characters is inside quotes, 0 otherwise.
+    bool pending_quote; ///< Whether there is a quote after the last recorded separator.
+    char delim; ///< The delimiter of the fields.
+    bool finished; ///< Whether the end of the input was reached.
+};
+
+/**
+ * @brief Creates a new CSV parser.
+ *
+ * The records are separated by line feeds, optionally preceded by a carriage return,
+ * and the fields are separated by a delimiter. Use ',' for CSV, or '\t' for TSV.
+ *
+ * @param delim The delimiter of the fields. Must not be a quote, a line feed, a carriage return or a null character.
+ * @return A pointer to the new parser, or nullptr if the delimiter is invalid or memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p csv_parser_free()
+ */
+LITE_ATTR_NODISCARD lite_csv_parser *csv_parser_new(const char delim) {
+    // The last block of the input is padded with null characters, which must not be taken for delimiters
+    if (delim == '"' || delim == '\n' || delim == '\r' || delim == '\0') return nullptr;
+
+    lite_csv_parser *const p = (lite_csv_parser *) calloc(1, sizeof(lite_csv_parser));
+    if (p == nullptr) return nullptr;
+    if ((p->buffer = string_new()) == nullptr) {
+        free(p);
+        return nullptr;
+    }
+    p->delim = delim;
+    return p;
+}
+
+/**
+ * @brief Frees the memory used by a CSV parser.
+ *
+ * If the input pointer is nullptr, the function does nothing.
+ *
+ * @param p A pointer to the parser to be freed.
+ */
+void csv_parser_free(lite_csv_parser *const restrict p) {
+    if (p) {
+        string_free(p->buffer);
+        free(p->ends);
+        free(p);
+    }
+}
+
+/**
+ * @brief Finds the quotes, the delimiters and the line feeds in 64 bytes of CSV input.
+ *
+ * @param block A pointer to the 64 bytes.
+ * @param delim The delimiter of the fields.
+ * @param delims A pointer where the bitmask of the delimiters will be stored.
+ * @param lines A pointer where the bitmask of the line feeds will be stored.
+ * @return The bitmask of the quotes.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_ALWAYS_INLINE static inline uint64_t
+lite_csv_masks_(const char *const restrict block, const char delim, uint64_t *const restrict delims,
+                uint64_t *const restrict lines) {
+    uint64_t quotes = 0, found_delims = 0, found_lines = 0;
+#if LITE_HAS_SSE2
+    const __m128i quote = _mm_set1_epi8('"'), line = _mm_set1_epi8('\n'), sep = _mm_set1_epi8(delim);
+    for (unsigned i = 0; i < 4; ++i) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (block + 16 * i));
+        quotes |= (uint64_t) (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << 16 * i;
+        found_delims |= (uint64_t) (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, sep)) << 16 * i;
+        found_lines |= (uint64_t) (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, line)) << 16 * i;
+    }
+#else
+    for (unsigned i = 0; i < 64; ++i) {
+        quotes |= (uint64_t) (block[i] == '"') << i;
+        found_delims |= (uint64_t) (block[i] == delim) << i;
+        found_lines |= (uint64_t) (block[i] == '\n') << i;
+    }
+#endif // LITE_HAS_SSE2
+    *delims = found_delims;
+    *lines = found_lines;
+    return quotes;
+}
+
+/**
+ * @brief Records the positions of the delimiters and line feeds outside of quotes in the new input of a CSV parser.
+ *
+ * @param p A pointer to the parser.
+ * @return true if the positions were recorded, false if memory allocation failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
+ */
+LITE_ATTR_HOT static bool lite_csv_index_(lite_csv_parser *const restrict p) {
+    const char *const data = p->buffer->data;
+    const size_t size = p->buffer->size;
+    char tail[64];
+
+    // The state is kept in locals, since the stores to the positions could alias the parser
+    size_t *ends = p->ends, count = p->end_count, i = p->scanned;
+    uint64_t inside = p->quoted;
+    bool pending_quote = p->pending_quote;
+    bool grown = true;
+    for (; i < size; i += 64) {
+        // A block has at most 64 separators
+        if (p->end_capacity - count < 64) {
+            const size_t capacity = p->end_capacity ? p->end_capacity * 2 : 1024;
+            if ((ends = (size_t *) realloc(p->ends, capacity * sizeof(size_t))) == nullptr) {
+                grown = false;
+                break;
+            }
+            p->ends = ends;
+            p->end_capacity = capacity;
+        }
+
+        // The last block is padded with zeros, which are neither quotes nor separators
+        const char *block = data + i;
+        if (size - i < 64) {
+            memset(tail, '\0', sizeof(tail));
+            memcpy(tail, block, size - i);
+            block = tail;
+        }
+        uint64_t delims, lines;
+        const uint64_t quotes = lite_csv_masks_(block, p->delim, &delims, &lines);
+
+        // A byte is quoted if an odd number of quotes precede it, counting the quote itself
+        uint64_t quoted = quotes;
+        quoted ^= quoted << 1;
+        quoted ^= quoted << 2;
+        quoted ^= quoted << 4;
+        quoted ^= quoted << 8;
+        quoted ^= quoted << 16;
+        quoted ^= quoted << 32;
+        quoted ^= inside;
+        inside = 0 - (quoted >> 63);
+
+        // Flag the separators that end a line, or a field with quotes
+        uint64_t pending = quotes;
+        for (uint64_t separators = (delims | lines) & ~quoted; separators; separators &= separators - 1) {
+            const unsigned bit = lite_ctz64_(separators);
+            const uint64_t before = (separators & (0 - separators)) - 1;
+            const bool has_quote = pending_quote || (pending & before);
+            ends[count++] = (i + bit) << 2 | (size_t) (lines >> bit & 1) | (has_quote ? LITE_CSV_QUOTED : 0);
+            pending &= ~before;
+            pending_quote = false;
+        }
+        pending_quote = pending_quote || pending;
+    }
+
+    p->end_count = count;
+    p->scanned = grown ? size : i;
+    p->quoted = inside;
+    p->pending_quote = pending_quote;
+    return grown;
+}
+
+/**
+ * @brief Appends a chunk of input to a CSV parser.
+ *
+ * The chunks can be cut anywhere, even inside a quoted field.
+ * The space of the records consumed so far is reclaimed first,
+ * which invalidates the fields returned by \p csv_parser_next()
+ *
+ * @param p A pointer to the parser.
+ * @param data A pointer to the chunk.
+ * @param len The number of characters in the chunk.
+ * @return true if the chunk was appended, false if the arguments are invalid,
+ * if \p csv_parser_finish() was called, or if memory allocation failed.
+ */
+bool csv_parser_feed_range(lite_csv_parser *const restrict p, const char *const restrict data, const size_t len) {
+    if (p == nullptr || (data == nullptr && len) || p->finished) return false;
+    lite_string *const buffer = p->buffer;
+
+    // Drop the consumed records without moving the characters
+    const size_t consumed = p->record_start;
+    if (consumed) {
+        lite_drop_front_(buffer, consumed);
+        const size_t pending = p->end_count - p->next_end;
+        for (size_t i = 0; i < pending; ++i) p->ends[i] = p->ends[p->next_end + i] - (consumed << 2);
+        p->end_count = pending;
+        p->next_end = 0;
+        p->record_start = 0;
+        p->scanned -= consumed;
+    }
+
+    if (len) {
+        // The positions of the separators are shifted left by 2
+        if (len > (SIZE_MAX >> 2) - buffer->size || !string_reserve(buffer, buffer->size + len)) return false;
+        memcpy(buffer->data + buffer->size, data, len);
+        buffer->size += len;
+    }
+    return lite_csv_index_(p);
+}
+
+/**
+ * @brief Appends a chunk of input to a CSV parser.
+ *
+ * @param p A pointer to the parser.
+ * @param chunk A pointer to the string holding the chunk.
+ * @return true if the chunk was appended, false otherwise.
+ *
+ * @see csv_parser_feed_range()
+ */
+bool csv_parser_feed(lite_csv_parser *const restrict p, const lite_string *const restrict chunk) {
+    return chunk && csv_parser_feed_range(p, chunk->data, chunk->size);
+}
+
+/**
+ * @brief Marks the end of the input of a CSV parser.
  *
- * @param s A pointer to the string to be duplicated.
- * @return A pointer to the new string, or nullptr if the duplication failed.
+ * The last record is returned by \p csv_parser_next() even if it does not end with a line feed.
  *
- * @note The returned pointer must be freed by the caller, using the \p string_free() function.
+ * @param p A pointer to the parser.
  */
-LITE_ATTR_NODISCARD lite_string *string_duplicate(const lite_string *const restrict s) {
-    if (s) {
-        lite_string *dup = string_new();
-        if (dup) {
-            if (string_copy(s, dup)) {
-                return dup;
-            }
-            string_free(dup);
-        }
-    }
-    return nullptr;
+void csv_parser_finish(lite_csv_parser *const restrict p) {
+    if (p) p->finished = true;
 }
 
 /**
- * @brief Reverses the order of characters in a string.
+ * @brief Cuts a field out of a CSV record, and unescapes it if it is quoted.
  *
- * @param s A pointer to the string to be reversed.
+ * The quotes of a quoted field are doubled inside it, and they are only unescaped, in place, if there are any.
+ *
+ * @param field A pointer to the first character of the field.
+ * @param len The number of characters in the field.
+ * @param view A pointer to the view where the field will be stored.
+ * @return true if the field is valid, false if it has a stray quote.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-void string_reverse(const lite_string *const restrict s) {
-    if (s) {
-        // Iterate over the first half of the string
-        for (size_t i = 0; i < s->size / 2; ++i) {
-            // Swap the character at the current position with the character at the symmetric position from the end
-            const char tmp = s->data[i];
-            s->data[i] = s->data[s->size - i - 1];
-            s->data[s->size - i - 1] = tmp;
+static bool lite_csv_field_(char *const restrict field, size_t len, lite_string_view *const restrict view) {
+    if (len == 0 || field[0] != '"') {
+        view->data = field;
+        view->size = len;
+        return memchr(field, '"', len) == nullptr;
+    }
+    if (len < 2 || field[len - 1] != '"') return false;
+
+    char *const first = field + 1;
+    const char *const stop = first + len - 2;
+    char *quote = (char *) memchr(first, '"', len - 2);
+    if (quote) {
+        char *out = quote;
+        const char *in = quote;
+        while (in < stop) {
+            if (in + 1 == stop || in[1] != '"') return false;
+            *out++ = '"';
+            in += 2;
+
+            // Move the run up to the next quote
+            const char *const next = (const char *) memchr(in, '"', (size_t) (stop - in));
+            const size_t run = (size_t) ((next ? next : stop) - in);
+            memmove(out, in, run);
+            out += run;
+            in += run;
         }
+        len = (size_t) (out - first) + 2;
     }
+    view->data = first;
+    view->size = len - 2;
+    return true;
 }
 
 /**
- * @brief Converts a string to a long long integer.
+ * @brief Parses the next record of a CSV parser into fields, without copying.
  *
- * @param s A pointer to the string to be converted.
- * @return The long long integer representation of the string, or 0 if the string is nullptr.
+ * The fields are returned as views into the buffer of the parser, with the quotes of quoted fields removed.
+ * They remain valid until the next call to \p csv_parser_feed() or \p csv_parser_free()\n
+ * If the record has more fields than \p max, nothing is stored and the record is not consumed,
+ * so the function can be called again with a larger array.
+ * A carriage return at the end of a record is removed, and an empty line is a record with a single empty field.
+ *
+ * @param p A pointer to the parser.
+ * @param fields A pointer to the array where the fields will be stored. Can be nullptr if \p max is 0.
+ * @param max The maximum number of fields to store.
+ * @return The number of fields of the record, 0 if there is no complete record yet,
+ * or \p lite_string_npos if the arguments are invalid, or if the record is malformed.
+ * A malformed record is skipped.
  */
-LITE_ATTR_REPRODUCIBLE long long string_to_ll(const lite_string *const restrict s) {
-    long long result = 0;
-    if (s) result = strtoll(string_cstr(s), nullptr, 10);
-    return result;
+LITE_ATTR_HOT size_t csv_parser_next(lite_csv_parser *const restrict p, lite_string_view *const restrict fields,
+                                     const size_t max) {
+    if (p == nullptr || (fields == nullptr && max)) return lite_string_npos;
+    char *const data = p->buffer->data;
+    const size_t size = p->buffer->size;
+
+    // Find the end of the record, which is the last one if the input is finished
+    size_t last = p->next_end;
+    while (last < p->end_count && !(p->ends[last] & LITE_CSV_LINE)) ++last;
+    size_t record_end, next_start, next_end;
+    if (last < p->end_count) {
+        record_end = p->ends[last] >> 2;
+        next_start = record_end + 1;
+        next_end = last + 1;
+    } else if (p->finished && p->record_start < size) {
+        record_end = next_start = size;
+        next_end = last;
+    } else return 0;
+
+    const size_t count = last - p->next_end + 1;
+    if (count > max) return count;
+
+    // The fields without quotes need no checks. The last record may not have a separator after it.
+    size_t start = p->record_start;
+    bool valid = true;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t index = p->next_end + i;
+        const size_t entry = index < p->end_count ? p->ends[index]
+                                                  : record_end << 2 | (p->pending_quote ? LITE_CSV_QUOTED : 0);
+        size_t end = entry >> 2;
+        if (i + 1 == count && end > start && data[end - 1] == '\r') --end;
+        if (entry & LITE_CSV_QUOTED) valid = lite_csv_field_(data + start, end - start, &fields[i]) && valid;
+        else {
+            fields[i].data = data + start;
+            fields[i].size = end - start;
+        }
+        start = end + 1;
+    }
+    p->record_start = next_start;
+    p->next_end = next_end;
+    return valid ? count : lite_string_npos;
 }
 
+
+/// The number of characters a line reader asks for at once.
+#define LITE_LINE_BLOCK ((size_t) 65536)
+
 /**
- * @brief Converts a string to an unsigned long long integer.
+ * @brief A buffered reader of the lines of a file.
  *
- * @param s A pointer to the string to be converted.
- * @return The unsigned long long integer representation of the string, or 0 if the string is nullptr.
+ * The file is read in large blocks into a single buffer, and the lines are handed out as views into it.
+ * The buffer starts at the current line. The lines handed out are dropped from its front without moving
+ * the rest, which is only moved back when more space is needed, so the buffer stops growing after the longest line.
  */
-LITE_ATTR_REPRODUCIBLE unsigned long long string_to_ull(const lite_string *const restrict s) {
-    unsigned long long result = 0;
-    if (s) result = strtoull(string_cstr(s), nullptr, 10);
-    return result;
-}
+struct lite_line_reader {
+    lite_string *buffer; ///< The characters read but not handed out yet, after the line handed out last.
+    size_t consumed; ///< The length of the line handed out last, including its line feed.
+    size_t scanned; ///< The number of characters at the front of the buffer known not to be line feeds.
+    FILE *file; ///< The file to read from, or nullptr to read from the file descriptor.
+    int fd; ///< The file descriptor to read from, if there is no file.
+    bool streaming; ///< Whether the file cannot seek, like a pipe or a terminal, so reads must not wait to fill up.
+    bool done; ///< Whether the end of the file was reached, or reading failed.
+};
 
 /**
- * @brief Converts a string to a long integer.
+ * @brief Creates a new line reader.
  *
- * @param s A pointer to the string to be converted.
- * @return The long integer representation of the string, or 0 if the string is nullptr.
+ * @param file The file to read from, or nullptr to read from the file descriptor.
+ * @param fd The file descriptor to read from.
+ * @return A pointer to the new reader, or nullptr if memory allocation failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-LITE_ATTR_REPRODUCIBLE long string_to_l(const lite_string *const restrict s) {
-    long result = 0;
-    if (s) result = strtol(string_cstr(s), nullptr, 10);
-    return result;
+static lite_line_reader *lite_line_reader_new_(FILE *const restrict file, const int fd) {
+    lite_line_reader *const r = (lite_line_reader *) calloc(1, sizeof(lite_line_reader));
+    if (r == nullptr) return nullptr;
+    if ((r->buffer = string_new()) == nullptr) {
+        free(r);
+        return nullptr;
+    }
+    r->file = file;
+    r->fd = fd;
+    r->streaming = file && ftell(file) < 0;
+    return r;
 }
 
 /**
- * @brief Converts a string to an unsigned long integer.
+ * @brief Creates a new reader of the lines of a file.
  *
- * @param s A pointer to the string to be converted.
- * @return The unsigned long integer representation of the string, or 0 if the string is nullptr.
+ * The reader uses its own buffer, so the file should not be read by other means while the reader is in use.
+ * Files that cannot seek, like pipes and terminals, are read through their file descriptor once their own buffer
+ * runs out, so lines are returned as soon as they arrive, and still read in blocks.
+ *
+ * @param file The file to read from.
+ * @return A pointer to the new reader, or nullptr if the file is invalid or memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p line_reader_free()
+ * @note The file is not closed by the reader.
  */
-LITE_ATTR_REPRODUCIBLE unsigned long string_to_ul(const lite_string *const restrict s) {
-    unsigned long result = 0;
-    if (s) result = strtoul(string_cstr(s), nullptr, 10);
-    return result;
+LITE_ATTR_NODISCARD lite_line_reader *line_reader_new(FILE *const restrict file) {
+    return file ? lite_line_reader_new_(file, -1) : nullptr;
 }
 
 /**
- * @brief Converts a string to an integer.
+ * @brief Creates a new reader of the lines of a file descriptor.
  *
- * @param s A pointer to the string to be converted.
- * @return The integer representation of the string, or 0 if the string is nullptr.
+ * @param fd The file descriptor to read from.
+ * @return A pointer to the new reader, or nullptr if the file descriptor is invalid or memory allocation failed.
+ * @note The returned pointer must be freed by the caller, using \p line_reader_free()
+ * @note The file descriptor is not closed by the reader.
  */
-LITE_ATTR_REPRODUCIBLE int string_to_int(const lite_string *const restrict s) {
-    return (int) string_to_l(s);
+LITE_ATTR_NODISCARD lite_line_reader *line_reader_new_fd(const int fd) {
+    return fd >= 0 ? lite_line_reader_new_(nullptr, fd) : nullptr;
 }
 
 /**
- * @brief Converts a string to an unsigned integer.
+ * @brief Frees the memory used by a line reader.
  *
- * @param s A pointer to the string to be converted.
- * @return The unsigned integer representation of the string, or 0 if the string is nullptr.
+ * If the input pointer is nullptr, the function does nothing.
+ *
+ * @param r A pointer to the reader to be freed.
  */
-LITE_ATTR_REPRODUCIBLE unsigned int string_to_uint(const lite_string *const restrict s) {
-    return (unsigned int) string_to_ul(s);
+void line_reader_free(lite_line_reader *const restrict r) {
+    if (r) {
+        string_free(r->buffer);
+        free(r);
+    }
 }
 
 /**
- * @brief Converts a string to a double.
+ * @brief Reads from a file descriptor, retrying if the call is interrupted.
  *
- * @param s A pointer to the string to be converted.
- * @return The double representation of the string, or 0.0 if the string is nullptr.
+ * @param fd The file descriptor to read from.
+ * @param buf A pointer to the memory where the characters will be stored.
+ * @param n The maximum number of characters to read.
+ * @return The number of characters read, 0 at the end of the file, or \p lite_string_npos if reading failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-LITE_ATTR_REPRODUCIBLE double string_to_double(const lite_string *const restrict s) {
-    double result = 0.0;
-    if (s) result = strtod(string_cstr(s), nullptr);
-    return result;
+static size_t lite_read_fd_(const int fd, void *const restrict buf, size_t n) {
+#if _WIN32
+    if (n > INT32_MAX) n = INT32_MAX;
+    const int result = _read(fd, buf, (unsigned) n);
+    return result < 0 ? lite_string_npos : (size_t) result;
+#elif LITE_HAS_FILES
+    while (true) {
+        const ssize_t result = read(fd, buf, n);
+        if (result >= 0) return (size_t) result;
+        if (errno != EINTR) return lite_string_npos;
+    }
+#else
+    (void) fd;
+    (void) buf;
+    (void) n;
+    return lite_string_npos;
+#endif // _WIN32
 }
 
 /**
- * @brief Converts a string to a float.
+ * @brief Reads from a pipe or a terminal, without waiting for more characters than have arrived.
  *
- * @param s A pointer to the string to be converted.
- * @return The float representation of the string, or 0.0f if the string is nullptr.
+ * Unlike \p fread(), this returns as soon as some characters are available, instead of waiting for the whole
+ * buffer to fill. What the file has buffered is taken first, without blocking. Once it runs out,
+ * the reader switches to the file descriptor, so each later read is a single \p read() call.\n
+ * Without the POSIX functions, the file is read one character at a time up to the end of the next line instead.
+ *
+ * @param r A pointer to the reader, which reads from a file.
+ * @param buffer The buffer to read into.
+ * @param size The size of the buffer, at least 1.
+ * @return The number of characters read, 0 at the end of the file, or \p lite_string_npos if reading the file
+ * descriptor failed.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-LITE_ATTR_REPRODUCIBLE float string_to_float(const lite_string *const restrict s) {
-    float result = 0.0f;
-    if (s) result = strtof(string_cstr(s), nullptr);
-    return result;
+static size_t lite_read_stream_(lite_line_reader *const restrict r, char *const restrict buffer, const size_t size) {
+#if LITE_HAS_FILES && !_WIN32 && defined(_GNU_SOURCE)
+    const int fd = fileno(r->file);
+    const int flags = fd < 0 ? -1 : fcntl(fd, F_GETFL);
+    if (flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0) {
+        const size_t n = fread(buffer, 1, size, r->file);
+        const bool end = feof(r->file);
+        fcntl(fd, F_SETFL, flags);
+        if (n == size || end) return n;
+
+        // The file stopped short of the end because nothing more has arrived, so its buffer is empty
+        clearerr(r->file);
+        r->file = nullptr;
+        r->fd = fd;
+        return n ? n : lite_read_fd_(fd, buffer, size);
+    }
+#endif
+    size_t n = 0;
+    while (n < size) {
+        const int c = getc(r->file);
+        if (c == EOF) break;
+        buffer[n++] = (char) c;
+        if (c == '\n') break;
+    }
+    return n;
 }
 
 /**
- * @brief Converts a string to a long double.
+ * @brief Moves the characters not handed out yet back to the start of the buffer of a line reader.
  *
- * @param s A pointer to the string to be converted.
- * @return The long double representation of the string, or 0.0 if the string is nullptr.
+ * Unlike \p lite_rebase_(), the space left behind is not cleared, since the buffer is only read up to its size.
+ * So each character read is written once, and the characters of the lines handed out are not touched again.
+ *
+ * @param buffer A pointer to the buffer of the reader.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-LITE_ATTR_REPRODUCIBLE long double string_to_ldouble(const lite_string *const restrict s) {
-    long double result = 0.0;
-    if (s) result = strtold(string_cstr(s), nullptr);
-    return result;
+static void lite_line_reader_rebase_(lite_string *const restrict buffer) {
+    char *const base = buffer->data - buffer->offset;
+    if (buffer->size) memmove(base, buffer->data, buffer->size);
+    buffer->data = base;
+    buffer->capacity += buffer->offset;
+    buffer->offset = 0;
 }
 
 /**
- * @brief Converts a long long integer to a string.
+ * @brief Reads the next line of a file.
  *
- * @param value The long long integer to be converted.
- * @return A pointer to the new string containing the long long integer, or nullptr if the string creation failed.
- * @note The returned pointer must be freed by the caller, using \p string_free()
+ * The line is returned as a view into the buffer of the reader, without its line feed,
+ * and without the carriage return before it. The view remains valid until the next call with the same reader.\n
+ * The lines can be of any length, and the last line does not need to end with a line feed.
+ *
+ * @param r A pointer to the reader.
+ * @param line A pointer to the view where the line will be stored.
+ * @return true if a line was read, false at the end of the file, if reading failed, or if the arguments are invalid.
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ll(const long long value) {
-    lite_string *s = string_new();
-    if (s) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%lld", value);
-        string_append_cstr(s, buf);
+LITE_ATTR_HOT bool line_reader_next(lite_line_reader *const restrict r, lite_string_view *const restrict line) {
+    if (r == nullptr || line == nullptr) return false;
+    lite_string *const buffer = r->buffer;
+    if (r->consumed) {
+        lite_drop_front_(buffer, r->consumed);
+        r->consumed = 0;
     }
-    return s;
+
+    size_t len;
+    while (true) {
+        const char *const feed = (const char *) memchr(buffer->data + r->scanned, '\n', buffer->size - r->scanned);
+        if (feed) {
+            len = (size_t) (feed - buffer->data);
+            r->consumed = len + 1;
+            break;
+        }
+        r->scanned = buffer->size;
+        if (r->done) {
+            if (buffer->size == 0) return false;
+            len = r->consumed = buffer->size;
+            break;
+        }
+
+        // Read the next block into the spare capacity, which only grows for lines longer than a block
+        if (lite_spare_(buffer) < LITE_LINE_BLOCK / 2 && buffer->offset) lite_line_reader_rebase_(buffer);
+        if (lite_spare_(buffer) < LITE_LINE_BLOCK / 2 &&
+            (buffer->size > SIZE_MAX - 1 - LITE_LINE_BLOCK || !string_reserve(buffer, buffer->size + LITE_LINE_BLOCK)))
+            return false;
+        char *const spare = buffer->data + buffer->size;
+        const size_t room = lite_spare_(buffer);
+        const size_t n = !r->file ? lite_read_fd_(r->fd, spare, room)
+                         : r->streaming ? lite_read_stream_(r, spare, room)
+                                        : fread(spare, 1, room, r->file);
+        if (n == 0 || n == lite_string_npos) r->done = true;
+        else buffer->size += n;
+    }
+
+    r->scanned = 0;
+    if (len && buffer->data[len - 1] == '\r') --len;
+    line->data = buffer->data;
+    line->size = len;
+    return true;
 }
 
 /**
- * @brief Converts an unsigned long long integer to a string.
+ * @brief Reads the next line of a file into a string.
  *
- * @param value The unsigned long long integer to be converted.
- * @return A pointer to the new string containing the unsigned long long integer,
- * or nullptr if the string creation failed.
- * @note The returned pointer must be freed by the caller, using \p string_free()
+ * The contents of the string are replaced by the line, without its line feed,
+ * and without the carriage return before it. The memory of the string is reused,
+ * so reading all the lines of a file into the same string only allocates for the longest one.
+ *
+ * @param r A pointer to the reader.
+ * @param s A pointer to the string where the line will be stored.
+ * @return true if a line was read, false at the end of the file, if reading failed,
+ * if the arguments are invalid, or if memory allocation failed.
+ *
+ * @see line_reader_next()
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ull(const unsigned long long value) {
-    lite_string *s = string_new();
-    if (s) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%llu", value);
-        string_append_cstr(s, buf);
-    }
-    return s;
+LITE_ATTR_HOT bool string_getline(lite_line_reader *const restrict r, lite_string *const restrict s) {
+    lite_string_view line;
+    if (s == nullptr || !line_reader_next(r, &line)) return false;
+
+    string_clear(s);
+    if (!string_reserve(s, line.size)) return false;
+    memcpy(s->data, line.data, line.size);
+    s->size = line.size;
+    return true;
 }
 
+
 /**
- * @brief Converts a long integer to a string.
+ * @brief Computes how many characters are left to read from a file descriptor, if it refers to a regular file.
  *
- * @param value The long integer to be converted.
- * @return A pointer to the new string containing the long integer, or nullptr if the string creation failed.
- * @note The returned pointer must be freed by the caller, using \p string_free()
+ * @param fd The file descriptor.
+ * @return The number of characters between the current position and the end of the file,
+ * or 0 if it is unknown, such as for pipes.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_l(const long value) {
-    lite_string *s = string_new();
-    if (s) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%ld", value);
-        string_append_cstr(s, buf);
-    }
-    return s;
+static size_t lite_fd_remaining_(const int fd) {
+#if _WIN32
+    struct _stat64 st;
+    if (_fstat64(fd, &st) != 0 || !(st.st_mode & _S_IFREG)) return 0;
+    const __int64 position = _lseeki64(fd, 0, SEEK_CUR);
+#elif LITE_HAS_FILES
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return 0;
+    const off_t position = lseek(fd, 0, SEEK_CUR);
+#endif // _WIN32
+
+#if LITE_HAS_FILES
+    if (position < 0 || position >= st.st_size) return 0;
+    const unsigned long long remaining = (unsigned long long) (st.st_size - position);
+    return remaining < SIZE_MAX / 2 ? (size_t) remaining : SIZE_MAX / 2;
+#else
+    (void) fd;
+    return 0;
+#endif // LITE_HAS_FILES
 }
 
 /**
- * @brief Converts an unsigned long integer to a string.
+ * @brief Reads characters from a file descriptor, and appends them to the end of a string.
  *
- * @param value The unsigned long integer to be converted.
- * @return A pointer to the new string containing the unsigned long integer, or nullptr if the string creation failed.
- * @note The returned pointer must be freed by the caller, using \p string_free()
+ * The characters are read directly into the spare capacity of the string.
+ * If the file descriptor refers to a regular file, the string is resized once for the rest of the file,
+ * otherwise it grows geometrically until the end of the file.
+ *
+ * @param s A pointer to the string where the characters will be appended.
+ * @param fd The file descriptor to read from.
+ * @param max The maximum number of characters to read, or \p lite_string_npos to read until the end of the file.
+ * @return The number of characters appended, or \p lite_string_npos if the arguments are invalid,
+ * if reading failed, or if memory allocation failed. The string is not modified on failure.
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ul(const unsigned long value) {
-    lite_string *s = string_new();
-    if (s) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%lu", value);
-        string_append_cstr(s, buf);
+size_t string_append_from_fd(lite_string *const restrict s, const int fd, const size_t max) {
+    if (s == nullptr || fd < 0) return lite_string_npos;
+    const size_t old_size = s->size;
+
+    // One more character than expected is asked for, so the end of the file is found without resizing
+    const size_t remaining = lite_fd_remaining_(fd);
+    if (remaining && max && lite_spare_(s) <= remaining) {
+        const size_t expected = remaining < max ? remaining + 1 : max;
+        if (expected > SIZE_MAX - 1 - s->size || !string_reserve(s, s->size + expected)) return lite_string_npos;
     }
-    return s;
+
+    size_t total = 0;
+    bool failed = false;
+    while (total < max) {
+        // Growing by a block is rounded up to the next power of 2, so the capacity doubles
+        if (lite_spare_(s) == 0 &&
+            (s->size > SIZE_MAX - 1 - LITE_LINE_BLOCK || !string_reserve(s, s->size + LITE_LINE_BLOCK))) {
+            failed = true;
+            break;
+        }
+        const size_t room = lite_spare_(s);
+        const size_t n = lite_read_fd_(fd, s->data + s->size, room < max - total ? room : max - total);
+        if (n == lite_string_npos) failed = true;
+        if (n == 0 || failed) break;
+        s->size += n;
+        total += n;
+    }
+
+    if (failed) {
+        // Restore the zeros past the end of the string
+        memset(s->data + old_size, '\0', s->size - old_size);
+        s->size = old_size;
+        return lite_string_npos;
+    }
+    return total;
 }
 
 /**
- * @brief Converts an integer to a string.
+ * @brief Reads the rest of a file descriptor into a new string.
  *
- * @param value The integer to be converted.
- * @return A pointer to the new string containing the integer.
+ * @param fd The file descriptor to read from.
+ * @return A pointer to the new string, or nullptr if the file descriptor is invalid,
+ * if reading failed, or if memory allocation failed.
  * @note The returned pointer must be freed by the caller, using \p string_free()
+ * @note The file descriptor is not closed.
+ *
+ * @see string_append_from_fd()
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_int(const int value) {
-    return string_from_l(value);
+LITE_ATTR_NODISCARD lite_string *string_read_fd(const int fd) {
+    if (fd < 0) return nullptr;
+
+    // A new string is allocated already zeroed, so the whole file is read without resizing
+    lite_string *const s = lite_new_with_capacity_(lite_fd_remaining_(fd) + 1);
+    if (s && string_append_from_fd(s, fd, lite_string_npos) == lite_string_npos) {
+        string_free(s);
+        return nullptr;
+    }
+    return s;
 }
 
 /**
- * @brief Converts an unsigned integer to a string.
+ * @brief Reads a whole file into a new string.
  *
- * @param value The unsigned integer to be converted.
- * @return A pointer to the new string containing the unsigned integer.
+ * @param path The path of the file.
+ * @return A pointer to the new string, or nullptr if the file could not be opened or read,
+ * or if memory allocation failed.
  * @note The returned pointer must be freed by the caller, using \p string_free()
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_uint(const unsigned int value) {
-    return string_from_ul(value);
+LITE_ATTR_NODISCARD lite_string *string_read_file(const char *const restrict path) {
+    if (path == nullptr) return nullptr;
+#if _WIN32
+    const int fd = _open(path, _O_RDONLY | _O_BINARY);
+#elif LITE_HAS_FILES
+#ifdef O_CLOEXEC
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+#else
+    const int fd = open(path, O_RDONLY);
+#endif // O_CLOEXEC
+#else
+    const int fd = -1;
+#endif // _WIN32
+    if (fd < 0) return nullptr;
+
+    lite_string *const s = string_read_fd(fd);
+#if _WIN32
+    _close(fd);
+#elif LITE_HAS_FILES
+    close(fd);
+#endif // _WIN32
+    return s;
 }
 
 /**
- * @brief Converts a double to a string.
+ * @brief Writes characters to a file descriptor, retrying after partial writes and interrupted calls.
  *
- * @param value The double to be converted.
- * @return A pointer to the new string containing the double, or nullptr if the string creation failed.
- * @note The returned pointer must be freed by the caller, using \p string_free()
+ * @param fd The file descriptor to write to.
+ * @param buf A pointer to the characters.
+ * @param n The number of characters.
+ * @return true if all the characters were written, false otherwise.
+ *
+ * @note This function is for internal use only, and should not be called directly by the user.
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_double(const double value) {
-    lite_string *s = string_new();
-    if (s) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%f", value);
-        string_append_cstr(s, buf);
+static bool lite_write_fd_(const int fd, const char *restrict buf, size_t n) {
+#if LITE_HAS_FILES
+    while (n) {
+#if _WIN32
+        const int written = _write(fd, buf, (unsigned) (n < INT32_MAX ? n : INT32_MAX));
+        if (written < 0) return false;
+#else
+        const ssize_t written = write(fd, buf, n);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+#endif // _WIN32
+        buf += written;
+        n -= (size_t) written;
     }
-    return s;
+    return true;
+#else
+    (void) fd;
+    (void) buf;
+    return n == 0;
+#endif // LITE_HAS_FILES
 }
 
 /**
- * @brief Converts a float to a string.
+ * @brief Writes a string to a file descriptor.
  *
- * @param value The float to be converted.
- * @return A pointer to the new string containing the float, or nullptr if the string creation failed.
- * @note The returned pointer must be freed by the caller, using \p string_free()
+ * The characters are written as they are, without a null terminator, and partial writes are continued.
+ *
+ * @param fd The file descriptor to write to.
+ * @param s A pointer to the string to be written.
+ * @return true if the whole string was written, false if the arguments are invalid or writing failed.
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_float(const float value) {
-    lite_string *s = string_new();
-    if (s) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%f", value);
-        string_append_cstr(s, buf);
-    }
-    return s;
+bool string_write_fd(const int fd, const lite_string *const restrict s) {
+    return fd >= 0 && s && lite_write_fd_(fd, s->data, s->size);
 }
 
+#if LITE_HAS_FILES && !_WIN32
+// The number of buffers passed to a single writev() call
+#if defined(IOV_MAX) && IOV_MAX < 1024
+#define LITE_IOV_MAX IOV_MAX
+#else
+#define LITE_IOV_MAX 1024 // The limit of Linux, macOS and the BSDs
+#endif // IOV_MAX
+#endif // LITE_HAS_FILES && !_WIN32
+
 /**
- * @brief Converts a long double to a string.
+ * @brief Writes an array of strings to a file descriptor, one after another.
  *
- * @param value The long double to be converted.
- * @return A pointer to the new string containing the long double, or nullptr if the string creation failed.
- * @note The returned pointer must be freed by the caller, using \p string_free()
+ * The strings are gathered into batches of up to \p IOV_MAX buffers, and each batch is written with
+ * a single \p writev() call, so many small strings take few system calls. Partial writes are continued.\n
+ * On platforms without \p writev() the strings are written one by one.
+ *
+ * @param fd The file descriptor to write to.
+ * @param strings A pointer to the array of strings. Can be nullptr if \p n is 0.
+ * @param n The number of strings.
+ * @return true if all the strings were written, false if the arguments are invalid or writing failed.
  */
-LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ldouble(const long double value) {
-    lite_string *s = string_new();
-    if (s) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%Lf", value);
-        string_append_cstr(s, buf);
+bool string_writev(const int fd, lite_string *const *const restrict strings, const size_t n) {
+    if (fd < 0 || (strings == nullptr && n)) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if (strings[i] == nullptr) return false;
     }
-    return s;
+
+#if LITE_HAS_FILES && !_WIN32
+    struct iovec iov[LITE_IOV_MAX];
+    size_t next = 0;
+    while (true) {
+        // Gather the next batch, skipping the empty strings
+        int count = 0;
+        for (; count < LITE_IOV_MAX && next < n; ++next) {
+            if (strings[next]->size) {
+                iov[count].iov_base = strings[next]->data;
+                iov[count].iov_len = strings[next]->size;
+                ++count;
+            }
+        }
+        if (count == 0) return true;
+
+        struct iovec *pending = iov;
+        while (count) {
+            const ssize_t written = writev(fd, pending, count);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            // Skip the buffers that were written completely, and continue the one written partially
+            size_t left = (size_t) written;
+            while (count && left >= pending->iov_len) {
+                left -= pending->iov_len;
+                ++pending;
+                --count;
+            }
+            if (count) {
+                pending->iov_base = (char *) pending->iov_base + left;
+                pending->iov_len -= left;
+            }
+        }
+    }
+#else
+    for (size_t i = 0; i < n; ++i) {
+        if (!lite_write_fd_(fd, strings[i]->data, strings[i]->size)) return false;
+    }
+    return true;
+#endif // LITE_HAS_FILES && !_WIN32
 }
@@ -89,6 +89,11 @@ extern "C" {
 #endif // __cplusplus
 
 #include <stddef.h>
+#include <stdio.h> // For FILE
+
+#if !(defined(__cplusplus) && __cplusplus) // char16_t and char32_t are keywords in C++
+#include <uchar.h>
+#endif // !__cplusplus
 
 #define lite_string_npos ((size_t) -1)
 
@@ -186,6 +191,35 @@ extern "C" {
 
 typedef struct lite_string lite_string; ///< The \p lite_string type.
 
+typedef struct lite_multi_pattern lite_multi_pattern; ///< A compiled set of patterns, for multi-pattern search.
+
+typedef struct lite_string_map lite_string_map; ///< A hash map from strings to pointers.
+
+typedef struct lite_csv_parser lite_csv_parser; ///< A streaming parser of CSV records.
+
+typedef struct lite_line_reader lite_line_reader; ///< A buffered reader of the lines of a file.
+
+/// A non-owning reference to a sequence of characters, such as a part of a string.
+typedef struct lite_string_view {
+    const char *data; ///< A pointer to the first character. The characters are not null-terminated.
+    size_t size; ///< The number of characters.
+} lite_string_view;
+
+/// A match reported by a multi-pattern search.
+typedef struct lite_pattern_match {
+    size_t pattern; ///< The index of the matched pattern.
+    size_t offset; ///< The index of the first character of the match in the string.
+} lite_pattern_match;
+
+/// The counts of lines, words and bytes in a text, which can be accumulated over several chunks.
+typedef struct lite_text_stats {
+    size_t lines; ///< The number of newline characters.
+    size_t words; ///< The number of runs of non-whitespace characters.
+    size_t bytes; ///< The number of bytes.
+    size_t spaces; ///< The number of whitespace characters.
+    bool in_word; ///< Whether the last byte counted is part of a word, which continues in the next chunk.
+} lite_text_stats;
+
 LITE_ATTR_NODISCARD LITE_ATTR_HOT lite_string *string_new(void);
 
 LITE_ATTR_HOT void string_free(lite_string *restrict s);
@@ -208,6 +242,20 @@ LITE_ATTR_REPRODUCIBLE char string_front(const lite_string *restrict s);
 
 LITE_ATTR_REPRODUCIBLE bool string_compare(const lite_string *restrict s1, const lite_string *restrict s2);
 
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT size_t string_hash(const lite_string *restrict s);
+
+LITE_ATTR_REPRODUCIBLE int string_cmp(const lite_string *restrict s1, const lite_string *restrict s2);
+
+bool string_sort(lite_string **restrict arr, size_t n);
+
+bool string_sort_parallel(lite_string **restrict arr, size_t n, size_t threads);
+
+size_t string_parallel_find_all(const lite_string *restrict s, const lite_string *restrict sub,
+                                size_t *restrict positions, size_t max, size_t threads);
+
+size_t string_view_parallel_find_all(lite_string_view text, lite_string_view pattern, size_t *restrict positions,
+                                     size_t max, size_t threads);
+
 LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT size_t string_length(const lite_string *restrict s);
 
 LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT size_t string_size(const lite_string *restrict s);
@@ -230,14 +278,29 @@ bool string_append(lite_string *restrict s1, const lite_string *restrict s2);
 
 bool string_append_cstr(lite_string *restrict s, const char *restrict cstr);
 
+LITE_ATTR_NODISCARD lite_string *string_join(lite_string *const *restrict parts, size_t n, const char *restrict sep);
+
+LITE_ATTR_NODISCARD lite_string *string_join_views(const lite_string_view *restrict views, size_t n,
+                                                   const char *restrict sep);
+
+bool string_append_join(lite_string *restrict dest, lite_string *const *restrict parts, size_t n,
+                        const char *restrict sep);
+
+bool string_append_join_views(lite_string *restrict dest, const lite_string_view *restrict views, size_t n,
+                              const char *restrict sep);
+
 LITE_ATTR_HOT char *string_cstr(const lite_string *restrict s);
 
 LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT char *string_data(const lite_string *restrict s);
 
 LITE_ATTR_REPRODUCIBLE bool string_compare_cstr(const lite_string *restrict s, const char *restrict cstr);
 
+LITE_ATTR_REPRODUCIBLE bool string_compare_mem(const lite_string *restrict s, const void *restrict data, size_t len);
+
 bool string_insert_cstr(lite_string *restrict s, const char *restrict cstr, size_t index);
 
+bool string_append_mem(lite_string *restrict s, const void *restrict data, size_t len);
+
 bool string_append_cstr_range(lite_string *restrict s, const char *restrict cstr, size_t count);
 
 bool string_copy_buffer(const lite_string *restrict s, char *buf);
@@ -246,10 +309,16 @@ bool string_copy(const lite_string *restrict src, lite_string *restrict dest);
 
 LITE_ATTR_REPRODUCIBLE bool string_case_compare(const lite_string *restrict s1, const lite_string *restrict s2);
 
+LITE_ATTR_REPRODUCIBLE int string_case_cmp(const lite_string *restrict s1, const lite_string *restrict s2);
+
+LITE_ATTR_REPRODUCIBLE size_t string_case_hash(const lite_string *restrict s);
+
 LITE_ATTR_REPRODUCIBLE bool string_case_compare_cstr(const lite_string *restrict s, const char *restrict cstr);
 
 bool string_swap(lite_string *restrict s1, lite_string *restrict s2);
 
+bool string_insert_mem(lite_string *restrict s, const void *restrict data, size_t index, size_t len);
+
 bool string_insert_cstr_range(lite_string *restrict s, const char *restrict cstr, size_t index, size_t count);
 
 bool string_insert_range(lite_string *restrict s, const lite_string *restrict sub, size_t index, size_t count);
@@ -292,6 +361,82 @@ LITE_ATTR_REPRODUCIBLE bool string_contains(const lite_string *restrict s, const
 
 LITE_ATTR_REPRODUCIBLE bool string_contains_cstr(const lite_string *restrict s, const char *restrict cstr);
 
+LITE_ATTR_REPRODUCIBLE size_t string_find_case(const lite_string *restrict s, const lite_string *restrict sub);
+
+LITE_ATTR_REPRODUCIBLE size_t string_find_case_cstr(const lite_string *restrict s, const char *restrict cstr);
+
+LITE_ATTR_REPRODUCIBLE bool string_contains_case(const lite_string *restrict s, const lite_string *restrict sub);
+
+LITE_ATTR_REPRODUCIBLE bool string_contains_case_cstr(const lite_string *restrict s, const char *restrict cstr);
+
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT size_t string_count_char(const lite_string *restrict s, char c);
+
+LITE_ATTR_REPRODUCIBLE size_t string_count_chars(const lite_string *restrict s, const char *restrict chars);
+
+LITE_ATTR_REPRODUCIBLE size_t string_count(const lite_string *restrict s, const lite_string *restrict sub,
+                                           bool overlapping);
+
+LITE_ATTR_REPRODUCIBLE size_t string_count_cstr(const lite_string *restrict s, const char *restrict cstr,
+                                                bool overlapping);
+
+LITE_ATTR_HOT size_t string_split(const lite_string *restrict s, char delim, lite_string_view *restrict views,
+                                  size_t max, bool keep_empty);
+
+LITE_ATTR_HOT size_t string_split_chars(const lite_string *restrict s, const char *restrict delims,
+                                        lite_string_view *restrict views, size_t max, bool keep_empty);
+
+LITE_ATTR_HOT size_t string_split_cstr(const lite_string *restrict s, const char *restrict sep,
+                                       lite_string_view *restrict views, size_t max, bool keep_empty);
+
+LITE_ATTR_NODISCARD lite_multi_pattern *multi_pattern_new(lite_string *const *restrict patterns, size_t count);
+
+LITE_ATTR_NODISCARD lite_multi_pattern *multi_pattern_new_cstr(const char *const *restrict patterns, size_t count);
+
+void multi_pattern_free(lite_multi_pattern *restrict mp);
+
+LITE_ATTR_REPRODUCIBLE size_t multi_pattern_size(const lite_multi_pattern *restrict mp);
+
+LITE_ATTR_HOT size_t multi_pattern_find_first(const lite_multi_pattern *restrict mp, const lite_string *restrict s,
+                                              size_t *restrict pattern);
+
+LITE_ATTR_HOT size_t multi_pattern_find_all(const lite_multi_pattern *restrict mp, const lite_string *restrict s,
+                                            lite_pattern_match *restrict matches, size_t max);
+
+LITE_ATTR_HOT bool multi_pattern_count(const lite_multi_pattern *restrict mp, const lite_string *restrict s,
+                                       size_t *restrict counts);
+
+LITE_ATTR_NODISCARD lite_string_map *string_map_new(void);
+
+void string_map_free(lite_string_map *restrict map);
+
+void string_map_clear(lite_string_map *restrict map);
+
+LITE_ATTR_REPRODUCIBLE size_t string_map_size(const lite_string_map *restrict map);
+
+bool string_map_reserve(lite_string_map *restrict map, size_t count);
+
+LITE_ATTR_HOT bool string_map_insert(lite_string_map *restrict map, lite_string *restrict key, void *value);
+
+LITE_ATTR_HOT bool string_map_insert_mem(lite_string_map *restrict map, const char *restrict key, size_t len,
+                                         void *value);
+
+LITE_ATTR_HOT void *string_map_get(const lite_string_map *restrict map, const lite_string *restrict key);
+
+LITE_ATTR_HOT void *string_map_get_mem(const lite_string_map *restrict map, const char *restrict key, size_t len);
+
+LITE_ATTR_HOT void *string_map_get_view(const lite_string_map *restrict map, lite_string_view key);
+
+LITE_ATTR_HOT bool string_map_contains(const lite_string_map *restrict map, const lite_string *restrict key);
+
+LITE_ATTR_HOT bool string_map_contains_mem(const lite_string_map *restrict map, const char *restrict key, size_t len);
+
+bool string_map_erase(lite_string_map *restrict map, const lite_string *restrict key);
+
+bool string_map_erase_mem(lite_string_map *restrict map, const char *restrict key, size_t len);
+
+bool string_map_next(const lite_string_map *restrict map, size_t *restrict cursor, const lite_string **restrict key,
+                     void **restrict value);
+
 LITE_ATTR_REPRODUCIBLE bool string_starts_with(const lite_string *restrict s, const lite_string *restrict sub);
 
 LITE_ATTR_REPRODUCIBLE bool string_starts_with_cstr(const lite_string *restrict s, const char *restrict cstr);
@@ -304,6 +449,24 @@ bool string_shrink(lite_string *restrict s, size_t size);
 
 bool string_shrink_to_fit(lite_string *restrict s);
 
+char *string_prepare_append(lite_string *restrict s, size_t n);
+
+bool string_commit_append(lite_string *restrict s, size_t written);
+
+bool string_resize_uninit(lite_string *restrict s, size_t size);
+
+LITE_ATTR_HOT bool string_trim(lite_string *restrict s);
+
+LITE_ATTR_HOT bool string_trim_left(lite_string *restrict s);
+
+LITE_ATTR_HOT bool string_trim_right(lite_string *restrict s);
+
+bool string_collapse_whitespace(lite_string *restrict s);
+
+LITE_ATTR_REPRODUCIBLE lite_string_view string_view_trim(lite_string_view view);
+
+LITE_ATTR_HOT bool string_count_stats(const lite_string *restrict s, lite_text_stats *restrict stats);
+
 void string_to_lower(const lite_string *restrict s);
 
 void string_to_upper(const lite_string *restrict s);
@@ -317,9 +480,19 @@ bool string_replace(lite_string *restrict s, const lite_string *restrict old_sub
 
 void string_replace_char(const lite_string *restrict s, char old_char, char new_char);
 
+bool string_translate(const lite_string *restrict s, const char *restrict from, const char *restrict to);
+
+bool string_delete_chars(lite_string *restrict s, const char *restrict set);
+
 bool string_replace_cstr(lite_string *restrict s, const char *restrict old_cstr,
                          const char *restrict new_cstr);
 
+size_t string_replace_n(lite_string *restrict s, const lite_string *restrict old_sub,
+                        const lite_string *restrict new_sub, size_t max);
+
+size_t string_replace_cstr_n(lite_string *restrict s, const char *restrict old_cstr,
+                             const char *restrict new_cstr, size_t max);
+
 bool string_erase_range(lite_string *restrict s, size_t start, size_t count);
 
 LITE_ATTR_NODISCARD lite_string *string_duplicate(const lite_string *restrict s);
@@ -362,6 +535,72 @@ LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_float(float v
 
 LITE_ATTR_NODISCARD LITE_ATTR_UNSEQUENCED lite_string *string_from_ldouble(long double value);
 
+LITE_ATTR_REPRODUCIBLE LITE_ATTR_HOT bool string_utf8_validate(const lite_string *restrict s);
+
+LITE_ATTR_REPRODUCIBLE size_t string_utf8_length(const lite_string *restrict s);
+
+LITE_ATTR_REPRODUCIBLE size_t string_utf8_offset(const lite_string *restrict s, size_t index);
+
+size_t string_to_utf16(const lite_string *restrict s, char16_t *restrict buf, size_t size);
+
+size_t string_to_utf32(const lite_string *restrict s, char32_t *restrict buf, size_t size);
+
+bool string_append_utf16(lite_string *restrict s, const char16_t *restrict src, size_t len);
+
+bool string_append_utf32(lite_string *restrict s, const char32_t *restrict src, size_t len);
+
+LITE_ATTR_NODISCARD lite_string *string_from_utf16(const char16_t *restrict src, size_t len);
+
+LITE_ATTR_NODISCARD lite_string *string_from_utf32(const char32_t *restrict src, size_t len);
+
+bool string_append_base64(lite_string *restrict s, const void *restrict data, size_t len, bool url_safe);
+
+bool string_decode_base64(const lite_string *restrict s, lite_string *restrict dest, bool url_safe);
+
+bool string_append_hex(lite_string *restrict s, const void *restrict data, size_t len, bool uppercase);
+
+bool string_decode_hex(const lite_string *restrict s, lite_string *restrict dest);
+
+bool string_url_encode(const lite_string *restrict s, lite_string *restrict dest);
+
+bool string_url_decode(const lite_string *restrict s, lite_string *restrict dest);
+
+bool string_append_json_escaped(lite_string *restrict s, const lite_string *restrict src);
+
+bool string_json_unescape(const lite_string *restrict s, lite_string *restrict dest);
+
+LITE_ATTR_NODISCARD lite_csv_parser *csv_parser_new(char delim);
+
+void csv_parser_free(lite_csv_parser *restrict p);
+
+bool csv_parser_feed(lite_csv_parser *restrict p, const lite_string *restrict chunk);
+
+bool csv_parser_feed_range(lite_csv_parser *restrict p, const char *restrict data, size_t len);
+
+void csv_parser_finish(lite_csv_parser *restrict p);
+
+LITE_ATTR_HOT size_t csv_parser_next(lite_csv_parser *restrict p, lite_string_view *restrict fields, size_t max);
+
+LITE_ATTR_NODISCARD lite_line_reader *line_reader_new(FILE *restrict file);
+
+LITE_ATTR_NODISCARD lite_line_reader *line_reader_new_fd(int fd);
+
+void line_reader_free(lite_line_reader *restrict r);
+
+LITE_ATTR_HOT bool line_reader_next(lite_line_reader *restrict r, lite_string_view *restrict line);
+
+LITE_ATTR_HOT bool string_getline(lite_line_reader *restrict r, lite_string *restrict s);
+
+size_t string_append_from_fd(lite_string *restrict s, int fd, size_t max);
+
+LITE_ATTR_NODISCARD lite_string *string_read_fd(int fd);
+
+LITE_ATTR_NODISCARD lite_string *string_read_file(const char *restrict path);
+
+bool string_write_fd(int fd, const lite_string *restrict s);
+
+bool string_writev(int fd, lite_string *const *restrict strings, size_t n);
+
 #if defined(__cplusplus) && __cplusplus
 }
 #endif
@@ -0,0 +1,36 @@
+// Calls from plain C to the functions that take arrays of strings.
+// C only converts lite_string ** to lite_string *const *, so these check that C callers need no casts.
+#include "../lite_string.h"
+
+// Writes "plain C" to a file descriptor, from an array of two strings
+bool c_writev_strings(const int fd) {
+    lite_string *strings[] = {string_new_cstr("plain "), string_new_cstr("C")};
+    const bool written = strings[0] && strings[1] && string_writev(fd, strings, 2);
+    string_free(strings[0]);
+    string_free(strings[1]);
+    return written;
+}
+
+// Joins "plain" and "C" into a new string, separated by a space
+lite_string *c_join_strings(void) {
+    lite_string *parts[] = {string_new_cstr("plain"), string_new_cstr("C")};
+    lite_string *joined = parts[0] && parts[1] ? string_join(parts, 2, " ") : nullptr;
+    if (joined && !string_append_join(joined, parts, 2, "")) {
+        string_free(joined);
+        joined = nullptr;
+    }
+    string_free(parts[0]);
+    string_free(parts[1]);
+    return joined;
+}
+
+// Compiles "plain" and "C" into a matcher, and returns the number of patterns in it
+size_t c_multi_pattern_size(void) {
+    lite_string *patterns[] = {string_new_cstr("plain"), string_new_cstr("C")};
+    lite_multi_pattern *mp = patterns[0] && patterns[1] ? multi_pattern_new(patterns, 2) : nullptr;
+    const size_t size = mp ? multi_pattern_size(mp) : 0;
+    multi_pattern_free(mp);
+    string_free(patterns[0]);
+    string_free(patterns[1]);
+    return size;
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "../lite_string.h"
+
+using Records = std::vector<std::vector<std::string>>;
+
+// Parses all the complete records available in a parser
+static bool drain(lite_csv_parser *p, Records &records) {
+    lite_string_view fields[16];
+    size_t count;
+    while ((count = csv_parser_next(p, fields, 16)) != 0) {
+        if (count == lite_string_npos || count > 16) return false;
+        std::vector<std::string> record;
+        for (size_t i = 0; i < count; ++i) record.emplace_back(fields[i].data, fields[i].size);
+        records.push_back(record);
+    }
+    return true;
+}
+
+TEST(LiteStringCsvTest, ParsesQuotedFields) {
+    lite_csv_parser *p = csv_parser_new(',');
+    ASSERT_NE(p, nullptr);
+    const std::string input = "name,quote,n\r\n"
+                              "\"Smith, J\",\"He said \"\"hi\"\"\",1\r\n"
+                              "\n"
+                              ",\"multi\nline\",\"\"\n"
+                              "last,row,3";
+    ASSERT_TRUE(csv_parser_feed_range(p, input.data(), input.size()));
+
+    Records records;
+    ASSERT_TRUE(drain(p, records));
+    EXPECT_EQ(records.size(), 4);
+    csv_parser_finish(p);
+    EXPECT_FALSE(csv_parser_feed_range(p, "x", 1));
+    ASSERT_TRUE(drain(p, records));
+
+    const Records expected = {
+        {"name", "quote", "n"}, {"Smith, J", "He said \"hi\"", "1"}, {""}, {"", "multi\nline", ""},
+        {"last", "row", "3"}
+    };
+    EXPECT_EQ(records, expected);
+    csv_parser_free(p);
+
+    // A record with more fields than the array is not consumed
+    p = csv_parser_new('\t');
+    lite_string *tsv = string_new_cstr("a\tb\tc\n");
+    ASSERT_TRUE(csv_parser_feed(p, tsv));
+    lite_string_view fields[3];
+    EXPECT_EQ(csv_parser_next(p, fields, 2), 3);
+    EXPECT_EQ(csv_parser_next(p, fields, 3), 3);
+    EXPECT_EQ(std::string(fields[2].data, fields[2].size), "c");
+    EXPECT_EQ(csv_parser_next(p, fields, 3), 0);
+    string_free(tsv);
+    csv_parser_free(p);
+
+    EXPECT_EQ(csv_parser_new('"'), nullptr);
+    EXPECT_EQ(csv_parser_new('\n'), nullptr);
+    EXPECT_EQ(csv_parser_new('\0'), nullptr);
+}
+
+TEST(LiteStringCsvTest, ResumesAcrossChunks) {
+    std::string input;
+    Records expected;
+    for (int i = 0; i < 300; ++i) {
+        std::vector<std::string> record = {std::to_string(i), "plain field " + std::to_string(i * 7)};
+        std::string line = record[0] + ',' + record[1];
+        if (i % 3 == 0) {
+            record.emplace_back("a \"quoted\", field\nwith a line feed");
+            line += ",\"a \"\"quoted\"\", field\nwith a line feed\"";
+        }
+        expected.push_back(record);
+        input += line + (i % 2 ? "\r\n" : "\n");
+    }
+
+    for (size_t chunk = 1; chunk <= 130; chunk += 7) {
+        lite_csv_parser *p = csv_parser_new(',');
+        Records records;
+        for (size_t i = 0; i < input.size(); i += chunk) {
+            ASSERT_TRUE(csv_parser_feed_range(p, input.data() + i, std::min(chunk, input.size() - i)));
+            ASSERT_TRUE(drain(p, records));
+        }
+        csv_parser_finish(p);
+        ASSERT_TRUE(drain(p, records));
+        EXPECT_EQ(records, expected) << chunk;
+        csv_parser_free(p);
+    }
+}
+
+TEST(LiteStringCsvTest, RejectsMalformedRecords) {
+    lite_csv_parser *p = csv_parser_new(',');
+    const std::string input = "a,b\"c\"\n\"x\"y,z\nok,1\n\"open";
+    ASSERT_TRUE(csv_parser_feed_range(p, input.data(), input.size()));
+    lite_string_view fields[4];
+    EXPECT_EQ(csv_parser_next(p, fields, 4), lite_string_npos);
+    EXPECT_EQ(csv_parser_next(p, fields, 4), lite_string_npos);
+
+    // Malformed records are skipped
+    ASSERT_EQ(csv_parser_next(p, fields, 4), 2);
+    EXPECT_EQ(std::string(fields[0].data, fields[0].size), "ok");
+    EXPECT_EQ(csv_parser_next(p, fields, 4), 0);
+    csv_parser_finish(p);
+    EXPECT_EQ(csv_parser_next(p, fields, 4), lite_string_npos);
+    EXPECT_EQ(csv_parser_next(p, fields, 4), 0);
+    EXPECT_EQ(csv_parser_next(nullptr, fields, 4), lite_string_npos);
+    csv_parser_free(p);
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include "../lite_string.h"
+
+TEST(LiteStringEncodingTest, EncodesBase64) {
+    // The test vectors of RFC 4648, section 10
+    const char *vectors[][2] = {
+        {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"}, {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="},
+        {"foobar", "Zm9vYmFy"}
+    };
+    for (const auto &vector: vectors) {
+        lite_string *s = string_new();
+        ASSERT_TRUE(string_append_base64(s, vector[0], strlen(vector[0]), false));
+        EXPECT_TRUE(string_compare_cstr(s, vector[1])) << vector[0];
+
+        lite_string *decoded = string_new();
+        ASSERT_TRUE(string_decode_base64(s, decoded, false));
+        EXPECT_TRUE(string_compare_cstr(decoded, vector[0]));
+        string_free(decoded);
+        string_free(s);
+    }
+
+    // The URL-safe alphabet replaces the last two characters, and drops the padding
+    const unsigned char bytes[] = {0xFB, 0xFF, 0xBF, 0x3E};
+    lite_string *s = string_new_cstr("std:");
+    ASSERT_TRUE(string_append_base64(s, bytes, sizeof bytes, false));
+    EXPECT_TRUE(string_compare_cstr(s, "std:+/+/Pg=="));
+    string_clear(s);
+    ASSERT_TRUE(string_append_base64(s, bytes, sizeof bytes, true));
+    EXPECT_TRUE(string_compare_cstr(s, "-_-_Pg"));
+    EXPECT_FALSE(string_append_base64(nullptr, bytes, 1, false));
+    string_free(s);
+}
+
+TEST(LiteStringEncodingTest, Base64RoundTripsInChunks) {
+    std::string data;
+    for (int i = 0; i < 1000; ++i) data += static_cast<char>(i * 7 + i / 13);
+
+    for (const bool url_safe: {false, true}) {
+        lite_string *whole = string_new(), *chunked = string_new(), *decoded = string_new();
+        ASSERT_TRUE(string_append_base64(whole, data.data(), data.size(), url_safe));
+
+        // Chunks with a size that is a multiple of 3 give the same output as a single call
+        for (size_t i = 0; i < data.size(); i += 48) {
+            const size_t chunk = std::min<size_t>(48, data.size() - i);
+            ASSERT_TRUE(string_append_base64(chunked, data.data() + i, chunk, url_safe));
+        }
+        EXPECT_TRUE(string_compare(whole, chunked));
+
+        ASSERT_TRUE(string_decode_base64(whole, decoded, url_safe));
+        EXPECT_EQ(std::string(string_data(decoded), string_size(decoded)), data);
+        string_free(whole);
+        string_free(chunked);
+        string_free(decoded);
+    }
+}
+
+TEST(LiteStringEncodingTest, RejectsInvalidBase64) {
+    const char *invalid[] = {
+        "Zg", "Zg=", "Z===", "Zh==", "Zm9=", "Zm9v\n", "Zm 9v", "Zm9v=Zm9v", "=Zm9", "Zm-_", "Zm9vYmFyZm9vYmFyZm9vYmF*",
+        "Zm9vYmFyZm9vYmFyZm9vYmFy\xc3\xa9Zg"
+    };
+    lite_string *dest = string_new_cstr("kept");
+    for (const char *cstr: invalid) {
+        lite_string *s = string_new_cstr(cstr);
+        EXPECT_FALSE(string_decode_base64(s, dest, false)) << cstr;
+        EXPECT_TRUE(string_compare_cstr(dest, "kept"));
+        string_free(s);
+    }
+
+    // Padding is optional with the URL-safe alphabet, but a single leftover character is never valid
+    lite_string *s = string_new_cstr("Zm9vYg");
+    EXPECT_TRUE(string_decode_base64(s, dest, true));
+    EXPECT_TRUE(string_compare_cstr(dest, "keptfoob"));
+    string_append_cstr(s, "==");
+    EXPECT_TRUE(string_decode_base64(s, dest, true));
+    EXPECT_TRUE(string_compare_cstr(dest, "keptfoobfoob"));
+    string_clear(s);
+    string_append_cstr(s, "Zm9vY");
+    EXPECT_FALSE(string_decode_base64(s, dest, true));
+    string_append_cstr(s, "+");
+    EXPECT_FALSE(string_decode_base64(s, dest, true));
+    string_free(s);
+    string_free(dest);
+}
+
+TEST(LiteStringEncodingTest, HexRoundTrips) {
+    std::string data;
+    for (int i = 0; i < 300; ++i) data += static_cast<char>(i);
+
+    lite_string *lower = string_new(), *upper = string_new();
+    ASSERT_TRUE(string_append_hex(lower, data.data(), data.size(), false));
+    ASSERT_TRUE(string_append_hex(upper, data.data(), data.size(), true));
+    EXPECT_EQ(string_size(lower), 600);
+    EXPECT_TRUE(string_starts_with_cstr(lower, "000102030405060708090a0b0c0d0e0f10"));
+    EXPECT_TRUE(string_contains_cstr(lower, "fdfeff0001020304"));
+    EXPECT_TRUE(string_ends_with_cstr(lower, "292a2b"));
+    EXPECT_TRUE(string_contains_cstr(upper, "FDFEFF0001020304"));
+
+    // Both cases decode to the same bytes
+    for (lite_string *hex: {lower, upper}) {
+        lite_string *decoded = string_new();
+        ASSERT_TRUE(string_decode_hex(hex, decoded));
+        EXPECT_EQ(std::string(string_data(decoded), string_size(decoded)), data);
+        string_free(decoded);
+    }
+    string_free(lower);
+    string_free(upper);
+}
+
+TEST(LiteStringEncodingTest, RejectsInvalidHex) {
+    const char *invalid[] = {"0", "0g", "abc", "0x12", "12 34", "00112233445566778899aabbccddeeffG0112233445566778899"};
+    lite_string *dest = string_new_cstr("kept");
+    for (const char *cstr: invalid) {
+        lite_string *s = string_new_cstr(cstr);
+        EXPECT_FALSE(string_decode_hex(s, dest)) << cstr;
+        EXPECT_TRUE(string_compare_cstr(dest, "kept"));
+        string_free(s);
+    }
+    EXPECT_FALSE(string_decode_hex(nullptr, dest));
+    string_free(dest);
+}
+
+TEST(LiteStringEncodingTest, UrlEncodesReservedCharacters) {
+    lite_string *s = string_new_cstr("/path/to a file?name=caf\xc3\xa9&x=1+2~_.-ABCxyz0189 and a long clean tail");
+    lite_string *encoded = string_new_cstr("https://host");
+    ASSERT_TRUE(string_url_encode(s, encoded));
+    EXPECT_TRUE(string_compare_cstr(encoded, "https://host%2Fpath%2Fto%20a%20file%3Fname%3Dcaf%C3%A9%26x%3D1%2B2~_.-"
+                                             "ABCxyz0189%20and%20a%20long%20clean%20tail"));
+
+    lite_string *decoded = string_new();
+    ASSERT_TRUE(string_url_decode(encoded, decoded));
+    EXPECT_TRUE(string_compare_cstr(decoded, "https://host/path/to a file?name=caf\xc3\xa9&x=1+2~_.-ABCxyz0189 "
+                                             "and a long clean tail"));
+    string_free(s);
+    string_free(encoded);
+    string_free(decoded);
+}
+
+TEST(LiteStringEncodingTest, UrlDecodeRejectsMalformedEscapes) {
+    lite_string *dest = string_new();
+    const char *invalid[] = {"%", "%4", "abc%", "%G1", "%1g", "a%%41", "100%"};
+    for (const char *cstr: invalid) {
+        lite_string *s = string_new_cstr(cstr);
+        EXPECT_FALSE(string_url_decode(s, dest)) << cstr;
+        EXPECT_EQ(string_size(dest), 0);
+        string_free(s);
+    }
+
+    // A long run of plain characters before the malformed escapes must not be written past the reserved size
+    lite_string *prefixed = string_new_cstr((std::string(38, 'a') + std::string(12, '%')).c_str());
+    EXPECT_FALSE(string_url_decode(prefixed, dest));
+    EXPECT_EQ(string_size(dest), 0);
+    EXPECT_EQ(std::string(string_cstr(dest)), "");
+    string_free(prefixed);
+
+    // Lowercase escapes and '+' are accepted as they are
+    lite_string *s = string_new_cstr("a%2fb+c%e2%82%AC");
+    ASSERT_TRUE(string_url_decode(s, dest));
+    EXPECT_TRUE(string_compare_cstr(dest, "a/b+c\xe2\x82\xac"));
+    string_free(s);
+    string_free(dest);
+}
+
+TEST(LiteStringEncodingTest, JsonEscapesSpecialCharacters) {
+    lite_string *s = string_new_cstr("say \"hi\"\\ to caf\xc3\xa9 /\b\f\n\r\t\x01\x1f end of a long clean tail");
+    lite_string *nul = string_new_cstr("00");
+    ASSERT_TRUE(string_decode_hex(nul, s));
+    lite_string *escaped = string_new_cstr("\"");
+    ASSERT_TRUE(string_append_json_escaped(escaped, s));
+    EXPECT_TRUE(string_compare_cstr(escaped, "\"say \\\"hi\\\"\\\\ to caf\xc3\xa9 /\\b\\f\\n\\r\\t\\u0001\\u001f "
+                                             "end of a long clean tail\\u0000"));
+
+    lite_string *unescaped = string_new();
+    lite_string *body = string_substr(escaped, 1, string_size(escaped) - 1);
+    ASSERT_TRUE(string_json_unescape(body, unescaped));
+    EXPECT_TRUE(string_compare(unescaped, s));
+    string_free(s);
+    string_free(escaped);
+    string_free(unescaped);
+    string_free(body);
+    string_free(nul);
+}
+
+TEST(LiteStringEncodingTest, JsonUnescapesUnicodeEscapes) {
+    lite_string *s = string_new_cstr("\\u00e9\\u20AC\\ud83d\\ude00\\/\\u0041");
+    lite_string *dest = string_new();
+    ASSERT_TRUE(string_json_unescape(s, dest));
+    EXPECT_TRUE(string_compare_cstr(dest, "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80/A"));
+    string_free(s);
+    string_clear(dest);
+
+    const char *invalid[] = {"\\", "a\\x", "\\u12", "\\u12G4", "\\ud83d", "\\ud83d\\u0041", "\\ude00", "a\"b",
+                             "tab\there"};
+    for (const char *cstr: invalid) {
+        s = string_new_cstr(cstr);
+        EXPECT_FALSE(string_json_unescape(s, dest)) << cstr;
+        EXPECT_EQ(string_size(dest), 0);
+        string_free(s);
+    }
+    string_free(dest);
+}
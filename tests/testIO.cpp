@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../lite_string.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Creates a temporary file with the given contents, positioned at its start
+static FILE *temp_file(const std::string &contents) {
+    FILE *file = tmpfile();
+    if (file) {
+        fwrite(contents.data(), 1, contents.size(), file);
+        fflush(file);
+        rewind(file);
+    }
+    return file;
+}
+
+TEST(LiteStringIOTest, ReadsLinesOfAnyLength) {
+    const std::string longLine(200000, 'x');
+    FILE *file = temp_file("first\r\n" + longLine + "\n\nlast\r");
+    ASSERT_NE(file, nullptr);
+    lite_line_reader *r = line_reader_new(file);
+    ASSERT_NE(r, nullptr);
+
+    lite_string_view line;
+    ASSERT_TRUE(line_reader_next(r, &line));
+    EXPECT_EQ(std::string(line.data, line.size), "first");
+    ASSERT_TRUE(line_reader_next(r, &line));
+    EXPECT_EQ(std::string(line.data, line.size), longLine);
+    ASSERT_TRUE(line_reader_next(r, &line));
+    EXPECT_EQ(line.size, 0);
+    ASSERT_TRUE(line_reader_next(r, &line));
+    EXPECT_EQ(std::string(line.data, line.size), "last");
+    EXPECT_FALSE(line_reader_next(r, &line));
+    EXPECT_FALSE(line_reader_next(r, &line));
+
+    line_reader_free(r);
+    fclose(file);
+    EXPECT_EQ(line_reader_new(nullptr), nullptr);
+    EXPECT_EQ(line_reader_new_fd(-1), nullptr);
+}
+
+TEST(LiteStringIOTest, GetlineReusesString) {
+    std::string contents;
+    for (int i = 0; i < 50000; ++i) contents += "line number " + std::to_string(i) + (i % 2 ? "\r\n" : "\n");
+    FILE *file = temp_file(contents);
+    ASSERT_NE(file, nullptr);
+    lite_line_reader *r = line_reader_new_fd(fileno(file));
+    ASSERT_NE(r, nullptr);
+
+    lite_string *s = string_new_cstr("previous contents");
+    int count = 0;
+    bool matches = true;
+    while (string_getline(r, s)) {
+        matches = matches && string_compare_cstr(s, ("line number " + std::to_string(count)).c_str());
+        ++count;
+    }
+    EXPECT_TRUE(matches);
+    EXPECT_EQ(count, 50000);
+
+    string_free(s);
+    line_reader_free(r);
+    fclose(file);
+}
+
+TEST(LiteStringIOTest, ReadsWholeFiles) {
+    std::string contents;
+    for (int i = 0; i < 100000; ++i) contents += std::to_string(i) + ' ';
+    const auto path = std::filesystem::temp_directory_path() / "lite_string_read_file.txt";
+    std::ofstream(path, std::ios::binary) << contents;
+
+    lite_string *s = string_read_file(path.string().c_str());
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(string_size(s), contents.size());
+    EXPECT_TRUE(string_compare_cstr(s, contents.c_str()));
+    string_free(s);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(string_read_file((path.string() + ".missing").c_str()), nullptr);
+    EXPECT_EQ(string_read_file(nullptr), nullptr);
+
+    // Reading continues from the current position, and appends at most the given number of characters
+    FILE *file = temp_file(contents);
+    ASSERT_NE(file, nullptr);
+    const int fd = fileno(file);
+    lite_string *prefix = string_new_cstr("> ");
+    EXPECT_EQ(string_append_from_fd(prefix, fd, 6), 6);
+    EXPECT_TRUE(string_compare_cstr(prefix, "> 0 1 2 "));
+    lite_string *rest = string_read_fd(fd);
+    ASSERT_NE(rest, nullptr);
+    EXPECT_TRUE(string_compare_cstr(rest, contents.c_str() + 6));
+    EXPECT_EQ(string_append_from_fd(prefix, fd, lite_string_npos), 0);
+    EXPECT_EQ(string_append_from_fd(prefix, -1, 10), lite_string_npos);
+    EXPECT_EQ(string_read_fd(-1), nullptr);
+    string_free(prefix);
+    string_free(rest);
+    fclose(file);
+}
+
+TEST(LiteStringIOTest, AppendsFromFdToStringWithoutSpareCapacity) {
+    const std::string contents(100000, 'f');
+    FILE *file = temp_file(contents);
+    ASSERT_NE(file, nullptr);
+
+    // A string shrunk to fit has no room left for the null terminator
+    lite_string *s = string_new_cstr("abc");
+    ASSERT_TRUE(string_shrink_to_fit(s));
+    EXPECT_EQ(string_append_from_fd(s, fileno(file), lite_string_npos), contents.size());
+    EXPECT_EQ(string_size(s), contents.size() + 3);
+    EXPECT_TRUE(string_compare_cstr(s, ("abc" + contents).c_str()));
+    string_free(s);
+    fclose(file);
+}
+
+#ifndef _WIN32
+TEST(LiteStringIOTest, ReadsPipesAndKeepsStringOnFailure) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const std::string contents(300000, 'p');
+    std::thread writer([&] {
+        for (size_t i = 0; i < contents.size(); i += 1000) EXPECT_EQ(write(fds[1], contents.data() + i, 1000), 1000);
+        close(fds[1]);
+    });
+    lite_string *s = string_read_fd(fds[0]);
+    writer.join();
+    close(fds[0]);
+    ASSERT_NE(s, nullptr);
+    EXPECT_TRUE(string_compare_cstr(s, contents.c_str()));
+    string_free(s);
+
+    // Reading a directory fails, and leaves the string unchanged
+    const int dir = open(std::filesystem::temp_directory_path().string().c_str(), O_RDONLY);
+    ASSERT_GE(dir, 0);
+    s = string_new_cstr("unchanged");
+    EXPECT_EQ(string_append_from_fd(s, dir, lite_string_npos), lite_string_npos);
+    EXPECT_TRUE(string_compare_cstr(s, "unchanged"));
+    string_free(s);
+    close(dir);
+}
+
+TEST(LiteStringIOTest, ReadsLinesFromPipesAsTheyArrive) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    FILE *file = fdopen(fds[0], "r");
+    ASSERT_NE(file, nullptr);
+    // The writer keeps the pipe open until the first line is read, or gives up after a few seconds
+    std::atomic<bool> received{false};
+    bool receivedInTime = false;
+    std::thread writer([&] {
+        EXPECT_EQ(write(fds[1], "header\nfirst\n", 13), 13);
+        for (int i = 0; i < 500 && !received; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        receivedInTime = received;
+        EXPECT_EQ(write(fds[1], "second\nthird", 12), 12);
+        close(fds[1]);
+    });
+    // The header is read by other means first, so the first line is already in the buffer of the file
+    char header[16];
+    ASSERT_NE(fgets(header, sizeof header, file), nullptr);
+    EXPECT_STREQ(header, "header\n");
+    lite_line_reader *r = line_reader_new(file);
+    ASSERT_NE(r, nullptr);
+    lite_string_view line;
+    ASSERT_TRUE(line_reader_next(r, &line));
+    received = true;
+    EXPECT_EQ(std::string(line.data, line.size), "first");
+    ASSERT_TRUE(line_reader_next(r, &line));
+    EXPECT_EQ(std::string(line.data, line.size), "second");
+    ASSERT_TRUE(line_reader_next(r, &line));
+    EXPECT_EQ(std::string(line.data, line.size), "third");
+    EXPECT_FALSE(line_reader_next(r, &line));
+    writer.join();
+    EXPECT_TRUE(receivedInTime);
+    line_reader_free(r);
+    fclose(file);
+}
+
+TEST(LiteStringIOTest, ReadsManyLinesFromPipedFiles) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    FILE *file = fdopen(fds[0], "r");
+    ASSERT_NE(file, nullptr);
+    // More lines than fit in the pipe, the buffer of the file, or a block of the reader
+    std::string contents;
+    for (int i = 0; i < 50000; ++i) contents += "line " + std::to_string(i) + "\n";
+    std::thread writer([&] {
+        for (size_t i = 0; i < contents.size(); i += 1000) {
+            const size_t n = std::min<size_t>(1000, contents.size() - i);
+            EXPECT_EQ(write(fds[1], contents.data() + i, n), static_cast<ssize_t>(n));
+        }
+        close(fds[1]);
+    });
+    lite_line_reader *r = line_reader_new(file);
+    ASSERT_NE(r, nullptr);
+    lite_string *s = string_new();
+    int count = 0;
+    bool inOrder = true;
+    while (string_getline(r, s)) {
+        inOrder = inOrder && string_compare_cstr(s, ("line " + std::to_string(count)).c_str());
+        ++count;
+    }
+    writer.join();
+    EXPECT_EQ(count, 50000);
+    EXPECT_TRUE(inOrder);
+    string_free(s);
+    line_reader_free(r);
+    fclose(file);
+}
+
+TEST(LiteStringIOTest, WritesManyStringsToPipes) {
+    // More strings than fit in one batch, and more characters than fit in a pipe, so the writes are partial
+    std::vector<lite_string *> strings;
+    std::string expected;
+    for (int i = 0; i < 5000; ++i) {
+        const std::string part = i % 7 ? std::to_string(i) + (i % 100 ? "," : std::string(1000, 'x')) : "";
+        strings.push_back(string_new_cstr(part.c_str()));
+        expected += part;
+    }
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    lite_string *received = nullptr;
+    std::thread reader([&] { received = string_read_fd(fds[0]); });
+    EXPECT_TRUE(string_writev(fds[1], strings.data(), strings.size()));
+    EXPECT_TRUE(string_write_fd(fds[1], strings[1]));
+    close(fds[1]);
+    reader.join();
+    close(fds[0]);
+    ASSERT_NE(received, nullptr);
+    EXPECT_TRUE(string_compare_cstr(received, (expected + "1,").c_str()));
+
+    EXPECT_TRUE(string_writev(1, nullptr, 0));
+    strings.push_back(nullptr);
+    EXPECT_FALSE(string_writev(1, strings.data(), strings.size()));
+    EXPECT_FALSE(string_write_fd(-1, received));
+    strings.pop_back();
+    for (lite_string *s: strings) string_free(s);
+    string_free(received);
+}
+
+extern "C" bool c_writev_strings(int fd);
+
+TEST(LiteStringIOTest, WritesStringArraysFromC) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    EXPECT_TRUE(c_writev_strings(fds[1]));
+    close(fds[1]);
+    lite_string *received = string_read_fd(fds[0]);
+    close(fds[0]);
+    ASSERT_NE(received, nullptr);
+    EXPECT_TRUE(string_compare_cstr(received, "plain C"));
+    string_free(received);
+}
+#endif
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../lite_string.h"
+
+TEST(LiteStringMapTest, NewMapIsEmpty) {
+    lite_string_map *map = string_map_new();
+    ASSERT_NE(map, nullptr);
+    EXPECT_EQ(string_map_size(map), 0);
+    EXPECT_EQ(string_map_get_mem(map, "key", 3), nullptr);
+    EXPECT_FALSE(string_map_contains_mem(map, "key", 3));
+    EXPECT_FALSE(string_map_erase_mem(map, "key", 3));
+    EXPECT_EQ(string_map_size(nullptr), 0);
+    string_map_free(map);
+    string_map_free(nullptr);
+}
+
+TEST(LiteStringMapTest, InsertTakesOwnershipOfKey) {
+    lite_string_map *map = string_map_new();
+    int one = 1, two = 2;
+
+    lite_string *key = string_new_cstr("alpha");
+    ASSERT_TRUE(string_map_insert(map, key, &one));
+    EXPECT_EQ(string_map_size(map), 1);
+    EXPECT_EQ(string_map_get_mem(map, "alpha", 5), &one);
+
+    // An equal key replaces the value, and the new key is freed by the map
+    ASSERT_TRUE(string_map_insert(map, string_new_cstr("alpha"), &two));
+    EXPECT_EQ(string_map_size(map), 1);
+    EXPECT_EQ(string_map_get_mem(map, "alpha", 5), &two);
+
+    lite_string *probe = string_new_cstr("alpha");
+    EXPECT_TRUE(string_map_contains(map, probe));
+    EXPECT_EQ(string_map_get(map, probe), &two);
+    string_free(probe);
+    string_map_free(map);
+}
+
+TEST(LiteStringMapTest, LooksUpBorrowedKeys) {
+    lite_string_map *map = string_map_new();
+    int value = 42;
+    ASSERT_TRUE(string_map_insert_mem(map, "name", 4, &value));
+    ASSERT_TRUE(string_map_insert_mem(map, "", 0, &value));
+
+    lite_string *line = string_new_cstr("name=value");
+    lite_string_view fields[2];
+    ASSERT_EQ(string_split(line, '=', fields, 2, true), 2);
+    EXPECT_EQ(string_map_get_view(map, fields[0]), &value);
+    EXPECT_EQ(string_map_get_view(map, fields[1]), nullptr);
+    EXPECT_TRUE(string_map_contains_mem(map, "", 0));
+    EXPECT_FALSE(string_map_contains_mem(map, "nam", 3));
+    EXPECT_EQ(string_map_size(map), 2);
+    string_free(line);
+    string_map_free(map);
+}
+
+TEST(LiteStringMapTest, GrowsAndErases) {
+    lite_string_map *map = string_map_new();
+    static int values[2000];
+    for (int i = 0; i < 2000; ++i) {
+        const std::string key = "key-" + std::to_string(i);
+        ASSERT_TRUE(string_map_insert_mem(map, key.data(), key.size(), &values[i]));
+    }
+    EXPECT_EQ(string_map_size(map), 2000);
+
+    for (int i = 0; i < 2000; i += 2) {
+        const std::string key = "key-" + std::to_string(i);
+        ASSERT_TRUE(string_map_erase_mem(map, key.data(), key.size()));
+    }
+    EXPECT_EQ(string_map_size(map), 1000);
+
+    for (int i = 0; i < 2000; ++i) {
+        const std::string key = "key-" + std::to_string(i);
+        EXPECT_EQ(string_map_get_mem(map, key.data(), key.size()), i % 2 ? &values[i] : nullptr);
+    }
+
+    // Reinsert into the erased slots
+    for (int i = 0; i < 2000; i += 2) {
+        const std::string key = "key-" + std::to_string(i);
+        ASSERT_TRUE(string_map_insert_mem(map, key.data(), key.size(), &values[i]));
+    }
+    EXPECT_EQ(string_map_size(map), 2000);
+    EXPECT_EQ(string_map_get_mem(map, "key-1998", 8), &values[1998]);
+    string_map_free(map);
+}
+
+TEST(LiteStringMapTest, IteratesOverAllEntries) {
+    lite_string_map *map = string_map_new();
+    ASSERT_TRUE(string_map_reserve(map, 100));
+    int values[100];
+    for (int i = 0; i < 100; ++i) {
+        values[i] = i;
+        const std::string key = std::to_string(i);
+        ASSERT_TRUE(string_map_insert_mem(map, key.data(), key.size(), &values[i]));
+    }
+
+    size_t cursor = 0, visited = 0;
+    const lite_string *key;
+    void *value;
+    while (string_map_next(map, &cursor, &key, &value)) {
+        EXPECT_EQ(std::to_string(*static_cast<int *>(value)), std::string(string_cstr(key)));
+        ++visited;
+    }
+    EXPECT_EQ(visited, 100);
+
+    string_map_clear(map);
+    EXPECT_EQ(string_map_size(map), 0);
+    cursor = 0;
+    EXPECT_FALSE(string_map_next(map, &cursor, &key, &value));
+    EXPECT_EQ(string_map_get_mem(map, "5", 1), nullptr);
+    string_map_free(map);
+}
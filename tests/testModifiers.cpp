@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 #include "../lite_string.h"
 
 TEST(LiteStringModifiersTest, PushBackIncreasesSize) {
@@ -221,6 +223,37 @@ TEST(LiteStringModifiersTest, InsertCStrResizesStringIfNeeded) {
     string_free(s);
 }
 
+TEST(LiteStringModifiersTest, AppendAndInsertMemAreBinarySafe) {
+    lite_string *s = string_new();
+    ASSERT_TRUE(string_append_mem(s, "a\0b", 3));
+    ASSERT_TRUE(string_insert_mem(s, "\0\0", 1, 2));
+    ASSERT_TRUE(string_insert_mem(s, "end", 5, 3));
+    EXPECT_EQ(string_size(s), 8);
+    EXPECT_TRUE(string_compare_mem(s, "a\0\0\0bend", 8));
+    EXPECT_FALSE(string_compare_mem(s, "a\0\0\0ben", 7));
+    EXPECT_FALSE(string_compare_cstr(s, "a"));
+
+    EXPECT_FALSE(string_insert_mem(s, "x", 9, 1));
+    EXPECT_TRUE(string_append_mem(s, nullptr, 0));
+    EXPECT_FALSE(string_append_mem(s, nullptr, 1));
+    EXPECT_FALSE(string_append_mem(nullptr, "x", 1));
+    EXPECT_TRUE(string_compare_mem(s, "a\0\0\0bend", 8));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, CStrRangeOnlyReadsTheRange) {
+    // The source is not null-terminated, so only the requested characters may be read
+    const std::vector<char> source(64, 'x');
+    lite_string *s = string_new();
+    ASSERT_TRUE(string_append_cstr_range(s, source.data(), 64));
+    ASSERT_TRUE(string_insert_cstr_range(s, source.data(), 10, 64));
+    EXPECT_EQ(string_size(s), 128);
+    EXPECT_FALSE(string_append_cstr_range(s, "short", 6));
+    EXPECT_FALSE(string_insert_cstr_range(s, "short", 0, 6));
+    EXPECT_TRUE(string_compare_mem(s, std::string(128, 'x').data(), 128));
+    string_free(s);
+}
+
 TEST(LiteStringModifiersTest, InsertRangeInsertsAtValidIndex) {
     lite_string *s = string_new();
     lite_string *sub = string_new_cstr("Hello");
@@ -378,6 +411,111 @@ TEST(LiteStringModifiersTest, ShrinkToFitDoesNothingWhenSizeIsCapacity) {
     string_free(s);
 }
 
+TEST(LiteStringModifiersTest, PrepareAndCommitAppendWriteInPlace) {
+    lite_string *s = string_new_cstr("value: ");
+    char *spare = string_prepare_append(s, 32);
+    ASSERT_NE(spare, nullptr);
+    const int written = snprintf(spare, 32, "%d", 12345);
+    ASSERT_TRUE(string_commit_append(s, written));
+    EXPECT_STREQ(string_cstr(s), "value: 12345");
+    EXPECT_TRUE(string_commit_append(s, 0));
+    EXPECT_FALSE(string_commit_append(s, string_capacity(s)));
+
+    // A string shrunk to fit has no room left until more is prepared
+    ASSERT_TRUE(string_shrink_to_fit(s));
+    EXPECT_FALSE(string_commit_append(s, 1));
+    spare = string_prepare_append(s, 1);
+    ASSERT_NE(spare, nullptr);
+    *spare = '!';
+    ASSERT_TRUE(string_commit_append(s, 1));
+    EXPECT_STREQ(string_cstr(s), "value: 12345!");
+    EXPECT_EQ(string_prepare_append(nullptr, 1), nullptr);
+    EXPECT_FALSE(string_commit_append(nullptr, 0));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, ResizeUninitGrowsAndShrinks) {
+    lite_string *s = string_new_cstr("abc");
+    ASSERT_TRUE(string_resize_uninit(s, 1000));
+    EXPECT_EQ(string_size(s), 1000);
+    memset(string_data(s) + 3, 'x', 997);
+    EXPECT_EQ(string_at(s, 999), 'x');
+    ASSERT_TRUE(string_resize_uninit(s, 2));
+    EXPECT_STREQ(string_cstr(s), "ab");
+    EXPECT_FALSE(string_resize_uninit(s, SIZE_MAX));
+    EXPECT_FALSE(string_resize_uninit(nullptr, 1));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, TrimRemovesWhitespaceFromBothEnds) {
+    lite_string *s = string_new_cstr(" \t\r\n  padded value with  inner  spaces \v\f\n");
+    ASSERT_TRUE(string_trim(s));
+    EXPECT_STREQ(string_cstr(s), "padded value with  inner  spaces");
+    ASSERT_TRUE(string_trim(s));
+    EXPECT_STREQ(string_cstr(s), "padded value with  inner  spaces");
+    EXPECT_FALSE(string_trim(nullptr));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, TrimLeftAndRightTrimOneEnd) {
+    lite_string *s = string_new_cstr("   left and right   ");
+    ASSERT_TRUE(string_trim_right(s));
+    EXPECT_STREQ(string_cstr(s), "   left and right");
+    ASSERT_TRUE(string_trim_left(s));
+    EXPECT_STREQ(string_cstr(s), "left and right");
+
+    string_clear(s);
+    string_append_cstr(s, "                                      ");
+    ASSERT_TRUE(string_trim(s));
+    EXPECT_TRUE(string_empty(s));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, TrimLeftReclaimsSpaceWhenGrowing) {
+    lite_string *s = string_new_cstr("                        0123456789");
+    const size_t old_capacity = string_capacity(s);
+    ASSERT_TRUE(string_trim_left(s));
+    EXPECT_STREQ(string_cstr(s), "0123456789");
+    EXPECT_LT(string_capacity(s), old_capacity);
+
+    // The skipped space is reused before the string is reallocated
+    ASSERT_TRUE(string_append_cstr(s, "abcdefghijklmnopqrstuv"));
+    EXPECT_STREQ(string_cstr(s), "0123456789abcdefghijklmnopqrstuv");
+    EXPECT_EQ(string_capacity(s), old_capacity);
+
+    for (int i = 0; i < 100; ++i) ASSERT_TRUE(string_push_back(s, 'x'));
+    EXPECT_EQ(string_size(s), 132);
+    EXPECT_EQ(string_at(s, 131), 'x');
+
+    ASSERT_TRUE(string_insert_cstr(s, "  ", 0));
+    ASSERT_TRUE(string_trim_left(s));
+    ASSERT_TRUE(string_shrink_to_fit(s));
+    EXPECT_EQ(string_capacity(s), string_size(s));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, CollapseWhitespaceShortensRuns) {
+    lite_string *s = string_new_cstr("  one\t\ttwo \n three    four  ");
+    ASSERT_TRUE(string_collapse_whitespace(s));
+    EXPECT_STREQ(string_cstr(s), " one two three four ");
+    ASSERT_TRUE(string_trim(s));
+    EXPECT_STREQ(string_cstr(s), "one two three four");
+    EXPECT_FALSE(string_collapse_whitespace(nullptr));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, ViewTrimTrimsSplitFields) {
+    lite_string *s = string_new_cstr(" a , b b ,, c");
+    lite_string_view views[4];
+    ASSERT_EQ(string_split(s, ',', views, 4, true), 4);
+    const char *expected[] = {"a", "b b", "", "c"};
+    for (int i = 0; i < 4; ++i) {
+        const lite_string_view field = string_view_trim(views[i]);
+        EXPECT_EQ(std::string(field.data, field.size), expected[i]);
+    }
+    string_free(s);
+}
+
 
 // Test copying a non-empty string to a buffer
 TEST(LiteStringModifiersTest, CopyingStringToBufferStoresCorrectValue) {
@@ -548,6 +686,36 @@ TEST(LiteStringModifiersTest, ReplaceNonExistentChar) {
     string_free(s);
 }
 
+TEST(LiteStringModifiersTest, TranslateMapsCharacters) {
+    lite_string *s = string_new_cstr("Hello, World! \t Tabs\tand\rreturns");
+    EXPECT_TRUE(string_translate(s, "\t\r,!", "  ;?"));
+    EXPECT_STREQ("Hello; World?   Tabs and returns", string_cstr(s));
+    EXPECT_TRUE(string_translate(s, "", ""));
+    EXPECT_FALSE(string_translate(s, "ab", "a"));
+    EXPECT_STREQ("Hello; World?   Tabs and returns", string_cstr(s));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, TranslateWithLargeSet) {
+    lite_string *s = string_new_cstr("the quick brown fox jumps over the lazy dog");
+    EXPECT_TRUE(string_translate(s, "abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+    EXPECT_STREQ("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG", string_cstr(s));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, DeleteCharsCompactsString) {
+    lite_string *s = string_new_cstr("a-b_c-d_e-f_g-h_i-j_k-l_m-n_o-p_q-r_s-t");
+    EXPECT_TRUE(string_delete_chars(s, "-_"));
+    EXPECT_STREQ("abcdefghijklmnopqrst", string_cstr(s));
+    EXPECT_EQ(string_length(s), 20);
+    EXPECT_TRUE(string_delete_chars(s, "aeiouxyzbcdfg"));
+    EXPECT_STREQ("hjklmnpqrst", string_cstr(s));
+    EXPECT_TRUE(string_delete_chars(s, ""));
+    EXPECT_STREQ("hjklmnpqrst", string_cstr(s));
+    EXPECT_FALSE(string_delete_chars(s, nullptr));
+    string_free(s);
+}
+
 TEST(LiteStringModifiersTest, ReplaceCStrInNonEmptyString) {
     lite_string *s = string_new_cstr("Hello, World!");
     EXPECT_TRUE(string_replace_cstr(s, "World", "User"));
@@ -583,6 +751,52 @@ TEST(LiteStringModifiersTest, ReplaceEmptyCStrWithCStr) {
     string_free(s);
 }
 
+TEST(LiteStringModifiersTest, ReplaceAllOccurrencesGrowingAndShrinking) {
+    lite_string *s = string_new_cstr("a-b-c-d-e");
+    EXPECT_TRUE(string_replace_cstr(s, "-", "<->"));
+    EXPECT_STREQ("a<->b<->c<->d<->e", string_cstr(s));
+    EXPECT_TRUE(string_replace_cstr(s, "<->", ","));
+    EXPECT_STREQ("a,b,c,d,e", string_cstr(s));
+    EXPECT_TRUE(string_replace_cstr(s, "a,", ""));
+    EXPECT_STREQ("b,c,d,e", string_cstr(s));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, ReplaceDoesNotRescanReplacement) {
+    lite_string *s = string_new_cstr("aaa");
+    EXPECT_TRUE(string_replace_cstr(s, "a", "aa"));
+    EXPECT_STREQ("aaaaaa", string_cstr(s));
+    EXPECT_TRUE(string_replace_cstr(s, "aa", "a"));
+    EXPECT_STREQ("aaa", string_cstr(s));
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, ReplaceManyOccurrences) {
+    lite_string *s = string_new();
+    for (int i = 0; i < 1000; ++i) ASSERT_TRUE(string_append_cstr(s, "{x}."));
+    EXPECT_TRUE(string_replace_cstr(s, "{x}", "value"));
+    EXPECT_EQ(string_length(s), 6000);
+    EXPECT_EQ(string_find_cstr(s, "{x}"), lite_string_npos);
+    EXPECT_EQ(string_rfind_cstr(s, "value."), 5994);
+    string_free(s);
+}
+
+TEST(LiteStringModifiersTest, ReplaceNStopsAtMaxCount) {
+    lite_string *s = string_new_cstr("one one one one");
+    lite_string *old_sub = string_new_cstr("one");
+    lite_string *new_sub = string_new_cstr("three");
+    EXPECT_EQ(string_replace_n(s, old_sub, new_sub, 2), 2);
+    EXPECT_STREQ("three three one one", string_cstr(s));
+    EXPECT_EQ(string_replace_cstr_n(s, "one", "1", 5), 2);
+    EXPECT_STREQ("three three 1 1", string_cstr(s));
+    EXPECT_EQ(string_replace_cstr_n(s, "one", "1", 5), 0);
+    EXPECT_EQ(string_replace_cstr_n(s, "three", "3", 0), 0);
+    EXPECT_EQ(string_replace_cstr_n(nullptr, "three", "3", 1), lite_string_npos);
+    string_free(s);
+    string_free(old_sub);
+    string_free(new_sub);
+}
+
 TEST(LiteStringModifiersTest, EraseRangeInNonEmptyString) {
     lite_string *s = string_new_cstr("Hello, World!");
     EXPECT_TRUE(string_erase_range(s, 0, 5));
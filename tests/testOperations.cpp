@@ -1,4 +1,7 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include "../lite_string.h"
 
 TEST(LiteStringOperationsTest, SubstrReturnsCorrectString) {
@@ -257,3 +260,374 @@ TEST(LiteStringOperationsTest, CaseCompareEmptyStringsReturnsTrue) {
     string_free(s1);
     string_free(s2);
 }
+
+TEST(LiteStringOperationsTest, SplitReturnsViewsIntoString) {
+    lite_string *s = string_new_cstr("2024-05-01,INFO,,server started");
+    lite_string_view views[8];
+    ASSERT_EQ(string_split(s, ',', views, 8, true), 4);
+    EXPECT_EQ(std::string(views[0].data, views[0].size), "2024-05-01");
+    EXPECT_EQ(std::string(views[1].data, views[1].size), "INFO");
+    EXPECT_EQ(views[2].size, 0);
+    EXPECT_EQ(std::string(views[3].data, views[3].size), "server started");
+    // The views point into the string
+    EXPECT_EQ(views[1].data - string_data(s), 11);
+
+    ASSERT_EQ(string_split(s, ',', views, 8, false), 3);
+    EXPECT_EQ(std::string(views[2].data, views[2].size), "server started");
+    string_free(s);
+}
+
+TEST(LiteStringOperationsTest, SplitCountsAllFieldsWhenBufferIsSmall) {
+    lite_string *s = string_new_cstr("a b c d e f g h i j k l m n o p q r s t u v w x y z");
+    lite_string_view views[4];
+    EXPECT_EQ(string_split(s, ' ', views, 4, true), 26);
+    EXPECT_EQ(std::string(views[3].data, views[3].size), "d");
+    EXPECT_EQ(string_split(s, ' ', nullptr, 0, true), 26);
+    EXPECT_EQ(string_split(s, ' ', nullptr, 4, true), lite_string_npos);
+    string_free(s);
+}
+
+TEST(LiteStringOperationsTest, SplitEmptyString) {
+    lite_string *s = string_new();
+    lite_string_view views[2];
+    EXPECT_EQ(string_split(s, ',', views, 2, true), 1);
+    EXPECT_EQ(views[0].size, 0);
+    EXPECT_EQ(string_split(s, ',', views, 2, false), 0);
+    string_free(s);
+}
+
+TEST(LiteStringOperationsTest, SplitCharsSplitsOnAnyDelimiter) {
+    lite_string *s = string_new_cstr("  key = value\tcomment\n");
+    lite_string_view views[8];
+    ASSERT_EQ(string_split_chars(s, " \t\n=", views, 8, false), 3);
+    EXPECT_EQ(std::string(views[0].data, views[0].size), "key");
+    EXPECT_EQ(std::string(views[1].data, views[1].size), "value");
+    EXPECT_EQ(std::string(views[2].data, views[2].size), "comment");
+    EXPECT_EQ(string_split_chars(s, "", views, 8, false), 1);
+    string_free(s);
+}
+
+TEST(LiteStringOperationsTest, SplitCStrSplitsOnSeparator) {
+    lite_string *s = string_new_cstr("one::two::::three::");
+    lite_string_view views[8];
+    ASSERT_EQ(string_split_cstr(s, "::", views, 8, true), 5);
+    EXPECT_EQ(std::string(views[0].data, views[0].size), "one");
+    EXPECT_EQ(std::string(views[1].data, views[1].size), "two");
+    EXPECT_EQ(views[2].size, 0);
+    EXPECT_EQ(std::string(views[3].data, views[3].size), "three");
+    EXPECT_EQ(views[4].size, 0);
+    EXPECT_EQ(string_split_cstr(s, "::", views, 8, false), 3);
+    EXPECT_EQ(string_split_cstr(s, "", views, 8, false), lite_string_npos);
+    string_free(s);
+}
+
+TEST(LiteStringOperationsTest, JoinStringsWithSeparator) {
+    lite_string *a = string_new_cstr("alpha");
+    lite_string *b = string_new();
+    lite_string *c = string_new_cstr("gamma");
+    lite_string *parts[] = {a, b, c};
+
+    lite_string *s = string_join(parts, 3, ", ");
+    ASSERT_NE(s, nullptr);
+    EXPECT_STREQ(string_cstr(s), "alpha, , gamma");
+    EXPECT_EQ(string_length(s), 14);
+    string_free(s);
+
+    s = string_join(parts, 3, nullptr);
+    ASSERT_NE(s, nullptr);
+    EXPECT_STREQ(string_cstr(s), "alphagamma");
+    string_free(s);
+
+    s = string_join(parts, 0, ",");
+    ASSERT_NE(s, nullptr);
+    EXPECT_TRUE(string_empty(s));
+    string_free(s);
+
+    lite_string *invalid[] = {a, nullptr};
+    EXPECT_EQ(string_join(invalid, 2, ","), nullptr);
+    string_free(a);
+    string_free(b);
+    string_free(c);
+}
+
+extern "C" lite_string *c_join_strings();
+
+TEST(LiteStringOperationsTest, JoinStringArraysFromC) {
+    lite_string *s = c_join_strings();
+    ASSERT_NE(s, nullptr);
+    EXPECT_STREQ(string_cstr(s), "plain CplainC");
+    string_free(s);
+}
+
+TEST(LiteStringOperationsTest, JoinViewsRoundTripsSplit) {
+    lite_string *s = string_new_cstr("a,bb,,ccc");
+    lite_string_view views[8];
+    const size_t n = string_split(s, ',', views, 8, true);
+    ASSERT_EQ(n, 4);
+
+    lite_string *joined = string_join_views(views, n, ",");
+    ASSERT_NE(joined, nullptr);
+    EXPECT_TRUE(string_compare(s, joined));
+    string_free(joined);
+    string_free(s);
+}
+
+TEST(LiteStringOperationsTest, AppendJoinAppendsToExistingString) {
+    lite_string *dest = string_new_cstr("list: ");
+    lite_string *a = string_new_cstr("x");
+    lite_string *b = string_new_cstr("y");
+    lite_string *parts[] = {a, b};
+
+    EXPECT_TRUE(string_append_join(dest, parts, 2, " | "));
+    EXPECT_STREQ(string_cstr(dest), "list: x | y");
+
+    const lite_string_view views[] = {{"1", 1}, {"23", 2}};
+    EXPECT_TRUE(string_append_join_views(dest, views, 2, "-"));
+    EXPECT_STREQ(string_cstr(dest), "list: x | y1-23");
+
+    lite_string *invalid[] = {a, nullptr};
+    EXPECT_FALSE(string_append_join(dest, invalid, 2, ","));
+    EXPECT_STREQ(string_cstr(dest), "list: x | y1-23");
+    EXPECT_FALSE(string_append_join(nullptr, parts, 2, ","));
+    string_free(dest);
+    string_free(a);
+    string_free(b);
+}
+
+TEST(LiteStringOperationsTest, HashIsEqualForEqualStrings) {
+    lite_string *a = string_new();
+    lite_string *b = string_new();
+    std::string text;
+    for (int len = 0; len < 200; ++len) {
+        ASSERT_TRUE(string_append_cstr(a, text.c_str() + string_length(a)));
+        ASSERT_TRUE(string_append_cstr(b, text.c_str() + string_length(b)));
+        EXPECT_EQ(string_hash(a), string_hash(b));
+        EXPECT_NE(string_hash(a), 0);
+        text += static_cast<char>('a' + len % 26);
+    }
+    EXPECT_EQ(string_hash(nullptr), 0);
+    string_free(a);
+    string_free(b);
+}
+
+TEST(LiteStringOperationsTest, HashDistinguishesSimilarStrings) {
+    lite_string *a = string_new_cstr("key-000");
+    lite_string *b = string_new_cstr("key-001");
+    lite_string *c = string_new_cstr("key-000 ");
+    EXPECT_NE(string_hash(a), string_hash(b));
+    EXPECT_NE(string_hash(a), string_hash(c));
+    string_free(a);
+    string_free(b);
+    string_free(c);
+}
+
+TEST(LiteStringOperationsTest, HashFollowsModifications) {
+    lite_string *a = string_new_cstr("Hello, World!");
+    lite_string *b = string_new_cstr("hello, world!");
+    const size_t original = string_hash(a);
+    EXPECT_NE(original, string_hash(b));
+    EXPECT_FALSE(string_compare(a, b));
+
+    string_to_lower(a);
+    EXPECT_EQ(string_hash(a), string_hash(b));
+    EXPECT_TRUE(string_compare(a, b));
+
+    string_set(a, 0, 'H');
+    EXPECT_FALSE(string_compare(a, b));
+    string_data(b)[0] = 'H';
+    EXPECT_TRUE(string_compare(a, b));
+    EXPECT_EQ(string_hash(a), string_hash(b));
+
+    ASSERT_TRUE(string_push_back(a, '!'));
+    EXPECT_NE(string_hash(a), string_hash(b));
+    string_pop_back(a);
+    EXPECT_EQ(string_hash(a), string_hash(b));
+    string_free(a);
+    string_free(b);
+}
+
+TEST(LiteStringOperationsTest, CompareSeesWritesThroughData) {
+    lite_string *a = string_new_cstr("hello");
+    lite_string *b = string_new_cstr("xello");
+    char *p = string_data(a);
+    EXPECT_NE(string_hash(a), string_hash(b));
+    p[0] = 'x';
+    EXPECT_TRUE(string_compare(a, b));
+    EXPECT_EQ(string_hash(a), string_hash(b));
+    string_free(a);
+    string_free(b);
+}
+
+TEST(LiteStringOperationsTest, CmpOrdersLexicographically) {
+    lite_string *a = string_new_cstr("apple");
+    lite_string *b = string_new_cstr("apples");
+    lite_string *c = string_new_cstr("banana");
+    lite_string *d = string_new_cstr("\xff");
+    EXPECT_LT(string_cmp(a, b), 0);
+    EXPECT_GT(string_cmp(b, a), 0);
+    EXPECT_LT(string_cmp(b, c), 0);
+    EXPECT_LT(string_cmp(c, d), 0);
+    EXPECT_EQ(string_cmp(a, a), 0);
+    EXPECT_LT(string_cmp(nullptr, a), 0);
+    EXPECT_EQ(string_cmp(nullptr, nullptr), 0);
+    string_free(a);
+    string_free(b);
+    string_free(c);
+    string_free(d);
+}
+
+static std::vector<lite_string *> make_sort_input(const size_t n) {
+    // Shared prefixes, embedded zeros and duplicates exercise every path of the sort
+    std::vector<lite_string *> strings;
+    unsigned state = 12345;
+    for (size_t i = 0; i < n; ++i) {
+        lite_string *s = string_new();
+        if (i % 3 == 0) string_append_cstr(s, "common-prefix-of-many-strings/");
+        state = state * 1103515245 + 12345;
+        const size_t len = state >> 16 & 15;
+        for (size_t j = 0; j < len; ++j) {
+            state = state * 1103515245 + 12345;
+            string_push_back(s, "ab\x01z"[state >> 16 & 3]);
+        }
+        strings.push_back(s);
+    }
+    return strings;
+}
+
+static bool is_sorted_by_cmp(const std::vector<lite_string *> &strings) {
+    return std::is_sorted(strings.begin(), strings.end(),
+                          [](const lite_string *x, const lite_string *y) { return string_cmp(x, y) < 0; });
+}
+
+TEST(LiteStringOperationsTest, SortOrdersStrings) {
+    std::vector<lite_string *> strings = make_sort_input(5000);
+    ASSERT_TRUE(string_sort(strings.data(), strings.size()));
+    EXPECT_TRUE(is_sorted_by_cmp(strings));
+    for (lite_string *s: strings) string_free(s);
+
+    EXPECT_TRUE(string_sort(nullptr, 0));
+    lite_string *invalid[] = {nullptr, nullptr};
+    EXPECT_FALSE(string_sort(invalid, 2));
+}
+
+TEST(LiteStringOperationsTest, SortParallelOrdersStrings) {
+    std::vector<lite_string *> strings = make_sort_input(50000);
+    std::vector<lite_string *> expected = strings;
+    ASSERT_TRUE(string_sort(expected.data(), expected.size()));
+
+    ASSERT_TRUE(string_sort_parallel(strings.data(), strings.size(), 5));
+    EXPECT_TRUE(is_sorted_by_cmp(strings));
+    for (size_t i = 0; i < strings.size(); ++i) EXPECT_EQ(string_cmp(strings[i], expected[i]), 0);
+
+    ASSERT_TRUE(string_sort_parallel(strings.data(), strings.size(), 0));
+    EXPECT_TRUE(is_sorted_by_cmp(strings));
+    for (lite_string *s: strings) string_free(s);
+}
+
+TEST(LiteStringOperationsTest, CaseCompareIncludesEmbeddedNulls) {
+    lite_string *a = string_new_cstr("Content-Type: TEXT/HTML; charset=UTF-8");
+    lite_string *b = string_new_cstr("content-type: text/html; CHARSET=utf-8");
+    EXPECT_TRUE(string_case_compare(a, b));
+
+    // The strings differ only after an embedded null character
+    lite_string *c = string_new_cstr("key?a");
+    lite_string *d = string_new_cstr("KEY?b");
+    string_data(c)[3] = '\0';
+    string_data(d)[3] = '\0';
+    EXPECT_EQ(string_length(c), 5);
+    EXPECT_FALSE(string_case_compare(c, d));
+    EXPECT_LT(string_case_cmp(c, d), 0);
+    string_free(a);
+    string_free(b);
+    string_free(c);
+    string_free(d);
+}
+
+TEST(LiteStringOperationsTest, CaseCmpOrdersIgnoringCase) {
+    lite_string *a = string_new_cstr("Apple");
+    lite_string *b = string_new_cstr("apples");
+    lite_string *c = string_new_cstr("BANANA");
+    lite_string *d = string_new_cstr("[");
+    EXPECT_LT(string_case_cmp(a, b), 0);
+    EXPECT_LT(string_case_cmp(b, c), 0);
+    EXPECT_GT(string_case_cmp(c, a), 0);
+    // '[' comes after 'Z' but before 'a'
+    EXPECT_LT(string_case_cmp(d, a), 0);
+    EXPECT_EQ(string_case_cmp(a, a), 0);
+    EXPECT_LT(string_case_cmp(nullptr, a), 0);
+    string_free(a);
+    string_free(b);
+    string_free(c);
+    string_free(d);
+}
+
+TEST(LiteStringOperationsTest, CaseHashIgnoresCase) {
+    std::string lower, upper;
+    for (int len = 0; len < 100; ++len) {
+        lite_string *a = string_new_cstr(lower.c_str());
+        lite_string *b = string_new_cstr(upper.c_str());
+        EXPECT_EQ(string_case_hash(a), string_case_hash(b));
+        EXPECT_EQ(string_case_hash(a), string_hash(a));
+        string_free(a);
+        string_free(b);
+        lower += static_cast<char>('a' + len % 26);
+        upper += static_cast<char>('A' + len % 26);
+    }
+    lite_string *x = string_new_cstr("x-forwarded-for");
+    lite_string *y = string_new_cstr("x-forwarded-fox");
+    EXPECT_NE(string_case_hash(x), string_case_hash(y));
+    EXPECT_EQ(string_case_hash(nullptr), 0);
+    string_free(x);
+    string_free(y);
+}
+
+TEST(LiteStringOperationsTest, CountStatsCountsLinesWordsAndBytes) {
+    lite_string *s = string_new_cstr("  Hello,\tworld!\r\nThis is\va\ftest.\n\nend");
+    lite_text_stats stats{};
+    ASSERT_TRUE(string_count_stats(s, &stats));
+    EXPECT_EQ(stats.lines, 3);
+    EXPECT_EQ(stats.words, 7);
+    EXPECT_EQ(stats.bytes, string_size(s));
+    EXPECT_EQ(stats.spaces, 10);
+    EXPECT_TRUE(stats.in_word);
+
+    EXPECT_FALSE(string_count_stats(nullptr, &stats));
+    EXPECT_FALSE(string_count_stats(s, nullptr));
+    string_free(s);
+}
+
+TEST(LiteStringOperationsTest, CountStatsCarriesWordsAcrossChunks) {
+    // A long text with every whitespace character and bytes above 0x7F, counted byte by byte as a reference
+    std::string text;
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < 20000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const char choices[] = " \t\n\v\f\rab\x89\xA0\xFF";
+        text += choices[(seed >> 16) % (sizeof choices - 1)];
+    }
+    size_t lines = 0, words = 0, spaces = 0;
+    bool in_word = false;
+    for (const char c: text) {
+        const bool ws = c == ' ' || (c >= '\t' && c <= '\r');
+        lines += c == '\n';
+        words += !ws && !in_word;
+        spaces += ws;
+        in_word = !ws;
+    }
+
+    for (const size_t chunk: {size_t{1}, size_t{7}, size_t{16}, size_t{100}, size_t{4096}, text.size()}) {
+        lite_text_stats stats{};
+        lite_string *s = string_new();
+        for (size_t i = 0; i < text.size(); i += chunk) {
+            string_clear(s);
+            ASSERT_TRUE(string_append_mem(s, text.data() + i, std::min(chunk, text.size() - i)));
+            ASSERT_TRUE(string_count_stats(s, &stats));
+        }
+        EXPECT_EQ(stats.lines, lines);
+        EXPECT_EQ(stats.words, words);
+        EXPECT_EQ(stats.spaces, spaces);
+        EXPECT_EQ(stats.bytes, text.size());
+        EXPECT_EQ(stats.in_word, in_word);
+        string_free(s);
+    }
+}
@@ -1,4 +1,7 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include "../lite_string.h"
 
 TEST(LiteStringSearchTest, FindLastOfReturnsCorrectIndex) {
@@ -149,3 +152,223 @@ TEST(LiteStringTest, FindLastNotOfCStrReturnsNposWhenNotFound) {
     EXPECT_EQ(index, lite_string_npos);
     string_free(s);
 }
+
+TEST(LiteStringSearchTest, MultiPatternFindFirstReturnsLeftmostMatch) {
+    const char *patterns[] = {"World", "lo, W", "Hello"};
+    lite_multi_pattern *mp = multi_pattern_new_cstr(patterns, 3);
+    ASSERT_NE(mp, nullptr);
+    EXPECT_EQ(multi_pattern_size(mp), 3);
+
+    lite_string *s = string_new_cstr("Say Hello, World!");
+    size_t pattern = lite_string_npos;
+    EXPECT_EQ(multi_pattern_find_first(mp, s, &pattern), 4);
+    EXPECT_EQ(pattern, 2);
+
+    string_free(s);
+    multi_pattern_free(mp);
+}
+
+TEST(LiteStringSearchTest, MultiPatternFindFirstReturnsNposWhenNotFound) {
+    const char *patterns[] = {"Planet", "Moon"};
+    lite_multi_pattern *mp = multi_pattern_new_cstr(patterns, 2);
+    lite_string *s = string_new_cstr("Hello, World!");
+    EXPECT_EQ(multi_pattern_find_first(mp, s, nullptr), lite_string_npos);
+    string_free(s);
+    multi_pattern_free(mp);
+}
+
+TEST(LiteStringSearchTest, MultiPatternFindAllReportsOverlappingMatches) {
+    const char *patterns[] = {"he", "she", "his", "hers"};
+    lite_multi_pattern *mp = multi_pattern_new_cstr(patterns, 4);
+    lite_string *s = string_new_cstr("ushers");
+
+    lite_pattern_match matches[8];
+    ASSERT_EQ(multi_pattern_find_all(mp, s, matches, 8), 3);
+    EXPECT_EQ(matches[0].pattern, 1);
+    EXPECT_EQ(matches[0].offset, 1);
+    EXPECT_EQ(matches[1].pattern, 0);
+    EXPECT_EQ(matches[1].offset, 2);
+    EXPECT_EQ(matches[2].pattern, 3);
+    EXPECT_EQ(matches[2].offset, 2);
+
+    // The total is returned even if the buffer is too small
+    EXPECT_EQ(multi_pattern_find_all(mp, s, matches, 1), 3);
+    EXPECT_EQ(multi_pattern_find_all(mp, s, nullptr, 0), 3);
+
+    string_free(s);
+    multi_pattern_free(mp);
+}
+
+extern "C" size_t c_multi_pattern_size();
+
+TEST(LiteStringSearchTest, MultiPatternFromStringArrayInC) {
+    EXPECT_EQ(c_multi_pattern_size(), 2);
+}
+
+TEST(LiteStringSearchTest, MultiPatternCountCountsEachPattern) {
+    lite_string *a = string_new_cstr("ab");
+    lite_string *b = string_new_cstr("b");
+    lite_string *c = string_new_cstr("ab");
+    lite_string *patterns[] = {a, b, c};
+    lite_multi_pattern *mp = multi_pattern_new(patterns, 3);
+    ASSERT_NE(mp, nullptr);
+
+    lite_string *s = string_new_cstr("abcabxbb");
+    size_t counts[3];
+    ASSERT_TRUE(multi_pattern_count(mp, s, counts));
+    EXPECT_EQ(counts[0], 2);
+    EXPECT_EQ(counts[1], 4);
+    EXPECT_EQ(counts[2], 2);
+
+    string_free(a);
+    string_free(b);
+    string_free(c);
+    string_free(s);
+    multi_pattern_free(mp);
+}
+
+TEST(LiteStringSearchTest, MultiPatternRejectsEmptyPatterns) {
+    const char *patterns[] = {"abc", ""};
+    EXPECT_EQ(multi_pattern_new_cstr(patterns, 2), nullptr);
+    EXPECT_EQ(multi_pattern_new_cstr(patterns, 0), nullptr);
+}
+
+TEST(LiteStringSearchTest, FindCaseIgnoresCase) {
+    lite_string *s = string_new_cstr("Hello, World!");
+    lite_string *sub = string_new_cstr("wORLD");
+    EXPECT_EQ(string_find_case(s, sub), 7);
+    EXPECT_EQ(string_find_case_cstr(s, "HELLO"), 0);
+    EXPECT_EQ(string_find_case_cstr(s, "d!"), 11);
+    EXPECT_TRUE(string_contains_case(s, sub));
+    EXPECT_TRUE(string_contains_case_cstr(s, "o, w"));
+    // The string is not modified
+    EXPECT_TRUE(string_compare_cstr(s, "Hello, World!"));
+    string_free(s);
+    string_free(sub);
+}
+
+TEST(LiteStringSearchTest, FindCaseReturnsNposWhenNotFound) {
+    lite_string *s = string_new_cstr("Hello, World!");
+    EXPECT_EQ(string_find_case_cstr(s, "Planet"), lite_string_npos);
+    EXPECT_EQ(string_find_case_cstr(s, "Hello, World!!"), lite_string_npos);
+    EXPECT_FALSE(string_contains_case_cstr(s, "[orld"));
+    string_free(s);
+}
+
+TEST(LiteStringSearchTest, FindCaseWorksOnLongStrings) {
+    lite_string *s = string_new();
+    for (int i = 0; i < 100; ++i) ASSERT_TRUE(string_append_cstr(s, "abcdefgh"));
+    ASSERT_TRUE(string_append_cstr(s, "NeedleInAHaystack"));
+    EXPECT_EQ(string_find_case_cstr(s, "needleinahaystack"), 800);
+    EXPECT_EQ(string_find_case_cstr(s, "HAYSTACK"), 809);
+    EXPECT_EQ(string_find_case_cstr(s, "HAB"), 7);
+    string_free(s);
+}
+
+TEST(LiteStringSearchTest, ParallelFindAllMatchesSequentialSearch) {
+    // Several megabytes of lines, so that the text is split between the threads
+    std::string text;
+    for (size_t i = 0; text.size() < (6 << 20); ++i) text += i % 5000 ? "lorem ipsum dolor\n" : "a needle\nneedle\n";
+    lite_string *s = string_new();
+    ASSERT_TRUE(string_append_mem(s, text.data(), text.size()));
+
+    for (const char *pattern: {"needle", "e\nn", "dolor\na "}) {
+        std::vector<size_t> expected;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+            expected.push_back(pos);
+
+        lite_string *sub = string_new_cstr(pattern);
+        std::vector<size_t> positions(expected.size());
+        ASSERT_EQ(string_parallel_find_all(s, sub, positions.data(), positions.size(), 4), expected.size());
+        EXPECT_EQ(positions, expected);
+        EXPECT_EQ(string_parallel_find_all(s, sub, nullptr, 0, 0), expected.size());
+
+        // Only the first positions are stored when the buffer is too small
+        std::vector<size_t> first(10);
+        ASSERT_EQ(string_parallel_find_all(s, sub, first.data(), first.size(), 3), expected.size());
+        EXPECT_TRUE(std::equal(first.begin(), first.end(), expected.begin()));
+        string_free(sub);
+    }
+    string_free(s);
+}
+
+TEST(LiteStringSearchTest, ParallelFindAllFindsMatchesAcrossChunks) {
+    // Without newlines, the 4 chunks start exactly at each mebibyte
+    std::string text(4 << 20, 'x');
+    const std::vector<size_t> expected{0, (1 << 20) - 3, (2 << 20) - 1, (3 << 20) - 5, (4 << 20) - 6};
+    for (const size_t pos: expected) text.replace(pos, 6, "needle");
+    lite_string *s = string_new();
+    ASSERT_TRUE(string_append_mem(s, text.data(), text.size()));
+    lite_string *sub = string_new_cstr("needle");
+
+    std::vector<size_t> positions(expected.size());
+    ASSERT_EQ(string_parallel_find_all(s, sub, positions.data(), positions.size(), 4), expected.size());
+    EXPECT_EQ(positions, expected);
+    string_free(s);
+    string_free(sub);
+}
+
+TEST(LiteStringSearchTest, ParallelFindAllHandlesEdgeCases) {
+    lite_string *s = string_new_cstr("abababa");
+    lite_string *sub = string_new_cstr("aba");
+    lite_string *empty = string_new();
+    size_t positions[4];
+    ASSERT_EQ(string_parallel_find_all(s, sub, positions, 4, 8), 3);
+    EXPECT_EQ(positions[0], 0);
+    EXPECT_EQ(positions[1], 2);
+    EXPECT_EQ(positions[2], 4);
+
+    EXPECT_EQ(string_parallel_find_all(sub, s, positions, 4, 1), 0);
+    EXPECT_EQ(string_parallel_find_all(empty, sub, positions, 4, 1), 0);
+    EXPECT_EQ(string_parallel_find_all(s, empty, positions, 4, 1), lite_string_npos);
+    EXPECT_EQ(string_parallel_find_all(s, sub, nullptr, 4, 1), lite_string_npos);
+    EXPECT_EQ(string_parallel_find_all(nullptr, sub, positions, 4, 1), lite_string_npos);
+    EXPECT_EQ(string_view_parallel_find_all({"xaba", 4}, {"ab", 2}, positions, 4, 0), 1);
+    EXPECT_EQ(positions[0], 1);
+    string_free(s);
+    string_free(sub);
+    string_free(empty);
+}
+
+TEST(LiteStringSearchTest, CountCharCountsEveryOccurrence) {
+    lite_string *s = string_new();
+    for (int i = 0; i < 1000; ++i) ASSERT_TRUE(string_append_cstr(s, "line one\nline two\n"));
+    ASSERT_TRUE(string_append_mem(s, "\0x\n", 3));
+    EXPECT_EQ(string_count_char(s, '\n'), 2001);
+    EXPECT_EQ(string_count_char(s, 'e'), 3000);
+    EXPECT_EQ(string_count_char(s, '\0'), 1);
+    EXPECT_EQ(string_count_char(s, 'z'), 0);
+    EXPECT_EQ(string_count_char(nullptr, 'a'), lite_string_npos);
+    string_free(s);
+}
+
+TEST(LiteStringSearchTest, CountCharsCountsSmallAndLargeSets) {
+    lite_string *s = string_new();
+    for (int i = 0; i < 100; ++i) ASSERT_TRUE(string_append_cstr(s, "a,b;c d\te,f;g h\n"));
+    EXPECT_EQ(string_count_chars(s, ",;"), 400);
+    EXPECT_EQ(string_count_chars(s, ";;;"), 200);
+    EXPECT_EQ(string_count_chars(s, " \t\n,;"), 800);
+    EXPECT_EQ(string_count_chars(s, "abcdefghijklmnopqrstuvwxyz"), 800);
+    EXPECT_EQ(string_count_chars(s, ""), 0);
+    EXPECT_EQ(string_count_chars(s, nullptr), lite_string_npos);
+    string_free(s);
+}
+
+TEST(LiteStringSearchTest, CountCountsSubstrings) {
+    lite_string *s = string_new_cstr("aaaa abab aaa");
+    lite_string *sub = string_new_cstr("aa");
+    lite_string *empty = string_new();
+    EXPECT_EQ(string_count(s, sub, false), 3);
+    EXPECT_EQ(string_count(s, sub, true), 5);
+    EXPECT_EQ(string_count_cstr(s, "aba", false), 1);
+    EXPECT_EQ(string_count_cstr(s, "a", false), 9);
+    EXPECT_EQ(string_count_cstr(s, "b", true), 2);
+    EXPECT_EQ(string_count_cstr(s, "aaaaa", true), 0);
+    EXPECT_EQ(string_count(empty, sub, true), 0);
+    EXPECT_EQ(string_count(s, empty, false), lite_string_npos);
+    EXPECT_EQ(string_count_cstr(s, "", false), lite_string_npos);
+    EXPECT_EQ(string_count_cstr(nullptr, "a", false), lite_string_npos);
+    string_free(s);
+    string_free(sub);
+    string_free(empty);
+}
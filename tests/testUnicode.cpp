@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../lite_string.h"
+
+TEST(LiteStringUnicodeTest, ValidatesUtf8) {
+    const char *valid[] = {
+        "", "plain ASCII", "caf\xc3\xa9", "\xe2\x82\xac 5", "\xf0\x9f\x98\x80 smile",
+        "\xed\x9f\xbf", "\xee\x80\x80", "\xf4\x8f\xbf\xbf", "\xc2\x80\xdf\xbf\xe0\xa0\x80\xef\xbf\xbf"
+    };
+    for (const char *cstr: valid) {
+        lite_string *s = string_new_cstr(cstr);
+        EXPECT_TRUE(string_utf8_validate(s)) << cstr;
+        string_free(s);
+    }
+
+    const char *invalid[] = {
+        "\x80", "abc\xbf", "\xc0\xaf", "\xc1\xbf", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xf0\x8f\xbf\xbf",
+        "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff", "\xc3", "\xe2\x82", "\xf0\x9f\x98", "\xc3" "A",
+        "\xe2\x82\xac\x80"
+    };
+    for (const char *cstr: invalid) {
+        lite_string *s = string_new_cstr(cstr);
+        EXPECT_FALSE(string_utf8_validate(s)) << cstr;
+        string_free(s);
+    }
+    EXPECT_FALSE(string_utf8_validate(nullptr));
+}
+
+TEST(LiteStringUnicodeTest, ValidatesSequencesAcrossBlocks) {
+    // Put a multibyte character at every position around the 16-byte blocks
+    for (size_t pad = 0; pad < 40; ++pad) {
+        std::string text(pad, 'x');
+        text += "\xf0\x9f\x98\x80";
+        text += std::string(pad % 7, 'y');
+
+        lite_string *s = string_new_cstr(text.c_str());
+        EXPECT_TRUE(string_utf8_validate(s)) << pad;
+        EXPECT_EQ(string_utf8_length(s), pad + 1 + pad % 7);
+
+        // Cutting the character short, or adding a stray continuation byte, makes it invalid
+        string_erase(s, pad + 3);
+        EXPECT_FALSE(string_utf8_validate(s)) << pad;
+        string_insert(s, pad + 3, '\x80');
+        string_insert(s, pad + 4, '\x80');
+        EXPECT_FALSE(string_utf8_validate(s)) << pad;
+        string_free(s);
+    }
+
+    // Embedded null characters are code points too
+    lite_string *s = string_new_cstr("a\xc3\xa9" "b");
+    string_data(s)[3] = '\0';
+    EXPECT_TRUE(string_utf8_validate(s));
+    EXPECT_EQ(string_utf8_length(s), 3);
+    string_free(s);
+}
+
+TEST(LiteStringUnicodeTest, FindsCodePointOffsets) {
+    std::string text;
+    for (int i = 0; i < 10; ++i) text += "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+    lite_string *s = string_new_cstr(text.c_str());
+    EXPECT_EQ(string_utf8_length(s), 40);
+
+    // Every group of four code points takes 10 bytes
+    const size_t offsets[] = {0, 1, 3, 6};
+    for (size_t i = 0; i < 40; ++i) EXPECT_EQ(string_utf8_offset(s, i), i / 4 * 10 + offsets[i % 4]) << i;
+    EXPECT_EQ(string_utf8_offset(s, 40), text.size());
+    EXPECT_EQ(string_utf8_offset(s, 41), lite_string_npos);
+
+    EXPECT_EQ(string_utf8_length(nullptr), 0);
+    EXPECT_EQ(string_utf8_offset(nullptr, 0), lite_string_npos);
+    string_free(s);
+
+    s = string_new();
+    EXPECT_EQ(string_utf8_length(s), 0);
+    EXPECT_EQ(string_utf8_offset(s, 0), 0);
+    EXPECT_EQ(string_utf8_offset(s, 1), lite_string_npos);
+    string_free(s);
+}
+
+TEST(LiteStringUnicodeTest, TranscodesToUtf16AndBack) {
+    std::string text;
+    for (int i = 0; i < 4; ++i) text += "ASCII text long enough for a block, \xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82\xd0\xbc\xd0\xb8\xd1\x80, \xe4\xb8\xad\xe6\x96\x87 \xf0\x9f\x98\x80.";
+    lite_string *s = string_new_cstr(text.c_str());
+
+    const std::u16string expected = u"ASCII text long enough for a block, Приветмир, 中文 😀.";
+    const size_t units = string_to_utf16(s, nullptr, 0);
+    ASSERT_EQ(units, expected.size() * 4);
+
+    // Nothing is written to a buffer that is too small
+    std::u16string utf16(units, u'#');
+    EXPECT_EQ(string_to_utf16(s, utf16.data(), units - 1), units);
+    EXPECT_EQ(utf16, std::u16string(units, u'#'));
+    EXPECT_EQ(string_to_utf16(s, utf16.data(), units), units);
+    EXPECT_EQ(utf16, expected + expected + expected + expected);
+
+    lite_string *back = string_from_utf16(utf16.data(), utf16.size());
+    ASSERT_NE(back, nullptr);
+    EXPECT_TRUE(string_compare(back, s));
+    string_free(back);
+
+    // Invalid UTF-8 is not transcoded
+    string_push_back(s, '\xc3');
+    EXPECT_EQ(string_to_utf16(s, utf16.data(), utf16.size()), lite_string_npos);
+    EXPECT_EQ(string_to_utf16(nullptr, nullptr, 0), lite_string_npos);
+    string_free(s);
+}
+
+TEST(LiteStringUnicodeTest, TranscodesToUtf32AndBack) {
+    const std::u32string text = U"Pure ASCII block, then éè and €￿ \U0001F600\U0010FFFF!";
+    lite_string *s = string_from_utf32(text.data(), text.size());
+    ASSERT_NE(s, nullptr);
+    EXPECT_TRUE(string_compare_cstr(s, "Pure ASCII block, then \xc3\xa9\xc3\xa8 and \xe2\x82\xac\xef\xbf\xbf "
+                                       "\xf0\x9f\x98\x80\xf4\x8f\xbf\xbf!"));
+
+    std::u32string utf32(string_to_utf32(s, nullptr, 0), U'\0');
+    EXPECT_EQ(string_to_utf32(s, utf32.data(), utf32.size()), text.size());
+    EXPECT_EQ(utf32, text);
+
+    // Surrogates and values above U+10FFFF are rejected, and the string is left unchanged
+    const char32_t surrogate[] = {U'a', 0xD800}, too_large[] = {0x110000};
+    EXPECT_FALSE(string_append_utf32(s, surrogate, 2));
+    EXPECT_FALSE(string_append_utf32(s, too_large, 1));
+    EXPECT_EQ(string_from_utf32(too_large, 1), nullptr);
+    EXPECT_EQ(string_utf8_length(s), text.size());
+    string_free(s);
+}
+
+TEST(LiteStringUnicodeTest, AppendsUtf16) {
+    lite_string *s = string_new_cstr(">");
+    const std::u16string text = u"éèàùçôîûâê"
+                                u"€ \U0001F600";
+    ASSERT_TRUE(string_append_utf16(s, text.data(), text.size()));
+    EXPECT_TRUE(string_compare_cstr(s, ">\xc3\xa9\xc3\xa8\xc3\xa0\xc3\xb9\xc3\xa7\xc3\xb4\xc3\xae\xc3\xbb\xc3\xa2"
+                                       "\xc3\xaa\xe2\x82\xac \xf0\x9f\x98\x80"));
+    EXPECT_TRUE(string_append_utf16(s, nullptr, 0));
+
+    // Unpaired surrogates are rejected
+    const char16_t high[] = {u'a', 0xD83D}, low[] = {0xDE00, u'a'}, swapped[] = {0xDE00, 0xD83D};
+    const size_t size = string_size(s);
+    EXPECT_FALSE(string_append_utf16(s, high, 2));
+    EXPECT_FALSE(string_append_utf16(s, low, 2));
+    EXPECT_FALSE(string_append_utf16(s, swapped, 2));
+    EXPECT_FALSE(string_append_utf16(nullptr, high, 1));
+    EXPECT_EQ(string_from_utf16(high, 2), nullptr);
+    EXPECT_EQ(string_size(s), size);
+    string_free(s);
+}